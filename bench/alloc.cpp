@@ -0,0 +1,63 @@
+#include "bench.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace Bench
+{
+
+static std::atomic<uint64_t> g_alloc_count = 0;
+static std::atomic<uint64_t> g_alloc_bytes = 0;
+
+static void* CountedAlloc(size_t size)
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+AllocStats GetAllocStats()
+{
+    return {g_alloc_count.load(std::memory_order_relaxed), g_alloc_bytes.load(std::memory_order_relaxed)};
+}
+
+void* ImGuiAlloc(size_t size, void*)
+{
+    return CountedAlloc(size);
+}
+
+void ImGuiFree(void* ptr, void*)
+{
+    std::free(ptr);
+}
+
+} // namespace Bench
+
+void* operator new(size_t size)
+{
+    if (auto ptr = Bench::CountedAlloc(size))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return Bench::CountedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return Bench::CountedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
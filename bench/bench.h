@@ -0,0 +1,69 @@
+#pragma once
+
+#include "imgui.h"
+
+namespace CatMenu
+{
+class RenderBackend;
+class SoftwareBackend;
+}
+
+namespace Bench
+{
+
+// A key event from the game's input device manager, as received by CatMenu's input hook: it
+// reaches ImGui through InputHandler on the next UI::Draw.
+void QueueKey(ImGuiKey key, bool down);
+
+// Counts every global operator new and ImGui allocation made by the process.
+struct AllocStats
+{
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+AllocStats GetAllocStats();
+void*      ImGuiAlloc(size_t size, void* user_data);
+void       ImGuiFree(void* ptr, void* user_data);
+
+// Synthetic plugins. Each one registers an overlay and a menu through UI.
+// Mixed cycles through the heavy workloads; Empty draws nothing, isolating the cost of the
+// frame loop itself (registry iteration, ID stack, profiling) from the plugins' ImGui calls.
+// Updated is TextHeavy with its data gathered by a (deliberately slow) update phase on the
+// worker pool instead of inside the draw func.
+enum class Workload : uint8_t
+{
+    TextHeavy,
+    WidgetHeavy,
+    ManyWindows,
+    COUNT,
+
+    Mixed = COUNT,
+    Empty,
+    Updated
+};
+// Overlays are registered with update_interval, see UI::RegisterOverlayDrawFunc. With
+// own_context, the plugin's funcs are drawn in a PluginContext of their own (Updated keeps its
+// overlay in CatMenu's context, and overlays in a plugin context ignore update_interval).
+void RegisterPlugin(int index, Workload workload, uint32_t update_interval, bool own_context);
+
+// Submits the frames of a draw capture (see CatMenu::DrawCapture) to backend, cycling
+// through them for frames submissions after warmup, and prints submit time percentiles.
+// With merge, each frame goes through CatMenu::DrawCmdMerger first and is checked to draw the
+// same as the original. Returns the exit code.
+int RunReplay(CatMenu::RenderBackend& backend, const char* path, int frames, int warmup, bool merge);
+
+// Renders CatMenu's config window, theme editor and a notification stack with the default
+// settings, times tessellation (UI build) and rasterization per frame, and compares the last
+// frame of each with the golden image DIR/<scene>.rgba (raw 8-bit RGBA rows, top to bottom),
+// writing it if missing or with update. Images with the same hash match outright, others are
+// compared pixel by pixel. A mismatch writes <scene>.actual.rgba and <scene>.diff.rgba next to
+// it. Returns the exit code.
+int RunGolden(CatMenu::SoftwareBackend& backend, const char* dir, bool update, int frames, int warmup);
+
+// Runs two scripted sessions of a plugin opening a big table through CatMenu::BufferSizer on a
+// mock device, the second presized from the first one's peak, and prints their buffer resizes
+// and mean capacity next to imgui_impl_dx11's own policy. Returns 1 if a frame did not fit, the
+// policy resized no less often than imgui_impl_dx11's, or presizing did not spare the growth.
+int RunBufferSizing();
+
+} // namespace Bench
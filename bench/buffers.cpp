@@ -0,0 +1,155 @@
+#include "bench.h"
+
+#include "buffer_sizer.h"
+
+namespace Bench
+{
+
+// Stands in for a renderer's buffers: counts what BufferSizer asks of it.
+struct MockBufferDevice : CatMenu::BufferDevice
+{
+    int      vertex_capacity = 0;
+    int      index_capacity  = 0;
+    uint64_t resizes         = 0;
+
+    bool ResizeVertexBuffer(int capacity) override
+    {
+        vertex_capacity = capacity;
+        ++resizes;
+        return true;
+    }
+    bool ResizeIndexBuffer(int capacity) override
+    {
+        index_capacity = capacity;
+        ++resizes;
+        return true;
+    }
+};
+
+// imgui_impl_dx11's own policy: grow to the frame plus a fixed margin, never shrink.
+struct StockSizing
+{
+    int      vertex_capacity = 0;
+    int      index_capacity  = 0;
+    uint64_t resizes         = 0;
+
+    void Reserve(int vertices, int indices)
+    {
+        if (!vertex_capacity || vertex_capacity < vertices) {
+            vertex_capacity = vertices + 5000;
+            ++resizes;
+        }
+        if (!index_capacity || index_capacity < indices) {
+            index_capacity = indices + 10000;
+            ++resizes;
+        }
+    }
+};
+
+// A session of a plugin opening a big table: an idle overlay, the table filling up row by row,
+// the table open, a long stretch with it closed, then opened again at full size.
+struct Phase
+{
+    const char* name;
+    int         frames;
+    int         from; // vertices needed at the start and at the end, ramped in between
+    int         to;
+};
+
+static const Phase g_session[] = {
+    {"idle", 600, 3000, 3000},
+    {"table filling", 600, 3000, 150000},
+    {"table open", 600, 150000, 150000},
+    {"table closed", 4000, 3000, 3000},
+    {"table reopened", 600, 150000, 150000},
+};
+
+struct SessionResult
+{
+    uint64_t adaptive_resizes      = 0;
+    uint64_t stock_resizes         = 0;
+    double   adaptive_kib          = 0.0;  // mean capacity held
+    double   stock_kib             = 0.0;
+    uint64_t resizes_before_closed = 0;    // adaptive, up to the table closing
+    bool     fits                  = true; // every frame fit the buffers BufferSizer asked for
+};
+
+static double BufferKiB(int vertices, int indices)
+{
+    return ((double)vertices * sizeof(ImDrawVert) + (double)indices * sizeof(ImDrawIdx)) / 1024.0;
+}
+
+static SessionResult RunSession(CatMenu::BufferSizer& sizer, MockBufferDevice& device)
+{
+    SessionResult result;
+    StockSizing   stock;
+    uint64_t      frames = 0;
+
+    // a little jitter, as rows scroll in and out of view
+    uint32_t rng = 12345;
+    for (const auto& phase : g_session) {
+        if (!std::strcmp(phase.name, "table closed"))
+            result.resizes_before_closed = device.resizes;
+
+        for (int i = 0; i < phase.frames; ++i) {
+            rng            = rng * 1664525u + 1013904223u;
+            const int base = phase.from + (int)((int64_t)(phase.to - phase.from) * i / std::max(phase.frames - 1, 1));
+            const int vtx  = std::max(0, base - (int)(rng >> 16) % std::max(base / 20, 1));
+            const int idx  = vtx * 3 / 2;
+
+            sizer.Reserve(vtx, idx);
+            stock.Reserve(vtx, idx);
+            result.fits = result.fits && device.vertex_capacity >= vtx && device.index_capacity >= idx;
+
+            result.adaptive_kib += BufferKiB(device.vertex_capacity, device.index_capacity);
+            result.stock_kib += BufferKiB(stock.vertex_capacity, stock.index_capacity);
+            ++frames;
+        }
+    }
+
+    result.adaptive_resizes = device.resizes;
+    result.stock_resizes    = stock.resizes;
+    result.adaptive_kib /= (double)frames;
+    result.stock_kib /= (double)frames;
+    return result;
+}
+
+int RunBufferSizing()
+{
+    std::printf("%-12s %16s %14s %16s %14s\n", "session", "adaptive resizes", "stock resizes", "adaptive KiB/f", "stock KiB/f");
+
+    auto report = [](const char* name, const SessionResult& result) {
+        std::printf("%-12s %16llu %14llu %16.0f %14.0f\n", name, (unsigned long long)result.adaptive_resizes,
+                    (unsigned long long)result.stock_resizes, result.adaptive_kib, result.stock_kib);
+    };
+
+    MockBufferDevice     first_device;
+    CatMenu::BufferSizer first(first_device);
+    const auto           cold = RunSession(first, first_device);
+    report("cold", cold);
+
+    // the next session, started from the peak the first one would have saved in settings
+    MockBufferDevice     second_device;
+    CatMenu::BufferSizer second(second_device);
+    second.Presize(first.GetPeakVertices(), first.GetPeakIndices());
+    const auto presized = RunSession(second, second_device);
+    report("presized", presized);
+
+    int exit_code = 0;
+    if (!cold.fits || !presized.fits) {
+        std::printf("FAIL: a frame did not fit the buffers\n");
+        exit_code = 1;
+    }
+    if (cold.adaptive_resizes >= cold.stock_resizes) {
+        std::printf("FAIL: no fewer resizes than imgui_impl_dx11's policy\n");
+        exit_code = 1;
+    }
+    if (presized.resizes_before_closed != 2) {
+        std::printf("FAIL: the presized session resized %llu times before the table closed, expected only creation\n",
+                    (unsigned long long)presized.resizes_before_closed);
+        exit_code = 1;
+    }
+    return exit_code;
+}
+
+} // namespace Bench
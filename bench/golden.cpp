@@ -0,0 +1,191 @@
+#include "bench.h"
+
+#include "backend.h"
+#include "draw_hash.h"
+#include "ui.h"
+
+namespace Bench
+{
+
+struct GoldenScene
+{
+    const char* name;
+    bool        menu_open;
+    void (*setup)(CatMenu::UI* ui);
+};
+
+static const GoldenScene g_scenes[] = {
+    {"config_window", true, [](CatMenu::UI* ui) { ui->ShowConfigWindow(true); }},
+    {"theme_editor", true, [](CatMenu::UI* ui) { ui->ShowThemeEditor(true); }},
+    {"notifications", false, [](CatMenu::UI*) {
+         // dismissed long after the run ends, so the stack is fully faded in and stays put
+         ImGui::InsertNotification({ImGuiToastType::Success, 3600000, "Settings saved."});
+         ImGui::InsertNotification({ImGuiToastType::Warning, 3600000, "Frame budget exceeded by 2 overlays."});
+         ImGui::InsertNotification({ImGuiToastType::Error, 3600000, "Failed to load main font.\nUsing backup font."});
+         ImGui::InsertNotification({ImGuiToastType::Info, 3600000, "Press \\ to open the menu."});
+     }},
+};
+
+// A channel further apart than this counts the pixel as changed; more changed pixels than
+// g_max_changed of the image fail the scene. Absorbs float rounding differences between
+// compilers without letting a moved or recoloured widget through.
+constexpr int    g_channel_tolerance = 8;
+constexpr double g_max_changed       = 0.0005;
+
+static void SetMenuOpen(CatMenu::UI* ui, bool open)
+{
+    if (ui->IsMenuOpen() == open)
+        return;
+
+    const auto key = ImGuiKey(ui->GetSettings().toggle_key);
+    QueueKey(key, true);
+    ui->Draw();
+    QueueKey(key, false);
+    ui->Draw();
+}
+
+static bool ChannelsDiffer(uint32_t a, uint32_t b)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+        if (std::abs((int)(a >> shift & 0xFF) - (int)(b >> shift & 0xFF)) > g_channel_tolerance)
+            return true;
+    return false;
+}
+
+// Goldens are raw pixels, so any image tool can open them given the size, e.g.
+// magick -size 1280x720 -depth 8 RGBA:config_window.rgba config_window.png
+static bool WriteRgba(const std::filesystem::path& path, std::span<const uint32_t> pixels)
+{
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(pixels.data()), (std::streamsize)pixels.size_bytes());
+    return (bool)file;
+}
+
+static bool ReadRgba(const std::filesystem::path& path, std::vector<uint32_t>& pixels)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    const auto size = (size_t)file.tellg();
+    pixels.resize(size / sizeof(uint32_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(pixels.data()), (std::streamsize)(pixels.size() * sizeof(uint32_t)));
+    return (bool)file && size % sizeof(uint32_t) == 0;
+}
+
+static double Percentile(std::vector<double>& samples, double p)
+{
+    if (samples.empty())
+        return 0.0;
+    std::ranges::sort(samples);
+    return samples[std::min(samples.size() - 1, (size_t)(p * (double)samples.size()))];
+}
+
+int RunGolden(CatMenu::SoftwareBackend& backend, const char* dir, bool update, int frames, int warmup)
+{
+    auto ui = CatMenu::UI::GetSingleton();
+
+    // whatever a config file next to the bench holds, the images are of the defaults
+    ui->GetSettings() = {};
+    ui->ApplySettings();
+    ui->Draw(); // fonts are rebuilt here, and notify if the font file is missing
+
+    // no software cursor in the images; in game the platform backend reports the mouse position,
+    // and this runs on the thread building frames
+    ImGui::GetIO().AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+
+    std::filesystem::create_directories(dir);
+
+    std::printf("%-14s %14s %14s %14s %14s  %s\n", "scene", "tess p50(ms)", "tess p99(ms)", "raster p50(ms)", "raster p99(ms)", "golden");
+
+    int exit_code = 0;
+
+    std::vector<double> tessellation, raster;
+    tessellation.reserve(frames);
+    raster.reserve(frames);
+
+    for (const auto& scene : g_scenes) {
+        ui->ShowConfigWindow(false);
+        ui->ShowThemeEditor(false);
+        ImGui::ClearNotifications();
+        SetMenuOpen(ui, scene.menu_open);
+        scene.setup(ui);
+
+        for (int i = 0; i < warmup; ++i)
+            ui->Draw();
+
+        tessellation.clear();
+        raster.clear();
+        for (int i = 0; i < frames; ++i) {
+            ui->Draw();
+
+            CatMenu::RenderStats stats;
+            if (ui->GetRenderStats(&stats, 1))
+                tessellation.push_back(stats.build_ms);
+
+            // UI just handed the frame over, but unchanged frames are not rasterized again; hash
+            // 0 forces it, so every sample is a full rasterization
+            if (auto draw_data = ui->GetSubmittedDrawData()) {
+                const auto before = std::chrono::steady_clock::now();
+                backend.RenderDrawData(draw_data, 0);
+                raster.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - before).count());
+            }
+        }
+
+        const auto pixels = std::span(backend.GetPixels(), (size_t)backend.GetWidth() * backend.GetHeight());
+        const auto hash   = CatMenu::HashBytes(pixels.data(), pixels.size_bytes());
+
+        std::string verdict;
+        const auto  path = std::filesystem::path(dir) / std::format("{}.rgba", scene.name);
+        if (update || !std::filesystem::exists(path)) {
+            if (WriteRgba(path, pixels))
+                verdict = std::format("written ({:016x})", hash);
+            else {
+                verdict   = "FAIL: could not write " + path.string();
+                exit_code = 1;
+            }
+        } else {
+            std::vector<uint32_t> golden;
+            if (!ReadRgba(path, golden)) {
+                verdict   = "FAIL: could not read " + path.string();
+                exit_code = 1;
+            } else if (golden.size() != pixels.size()) {
+                verdict   = std::format("FAIL: golden has {} pixels, rendered {}x{}", golden.size(), backend.GetWidth(), backend.GetHeight());
+                exit_code = 1;
+            } else if (CatMenu::HashBytes(golden.data(), golden.size() * sizeof(uint32_t)) == hash) {
+                verdict = std::format("match ({:016x})", hash);
+            } else {
+                // changed pixels red over a faded copy of the golden
+                std::vector<uint32_t> diff(golden.size());
+                size_t                changed = 0;
+                for (size_t i = 0; i < golden.size(); ++i) {
+                    if (ChannelsDiffer(golden[i], pixels[i])) {
+                        diff[i] = 0xFF0000FF;
+                        ++changed;
+                    } else
+                        diff[i] = (golden[i] >> 2 & 0x003F3F3F) | 0xFF000000;
+                }
+
+                if ((double)changed > g_max_changed * (double)golden.size()) {
+                    auto actual_path = path, diff_path = path;
+                    actual_path.replace_extension(".actual.rgba");
+                    diff_path.replace_extension(".diff.rgba");
+                    WriteRgba(actual_path, pixels);
+                    WriteRgba(diff_path, diff);
+                    verdict   = std::format("FAIL: {} pixels changed, see {}", changed, diff_path.string());
+                    exit_code = 1;
+                } else
+                    verdict = std::format("match ({} pixels changed)", changed);
+            }
+        }
+
+        const double tess_p50 = Percentile(tessellation, 0.5), tess_p99 = Percentile(tessellation, 0.99);
+        const double rast_p50 = Percentile(raster, 0.5), rast_p99 = Percentile(raster, 0.99);
+        std::printf("%-14s %14.3f %14.3f %14.3f %14.3f  %s\n", scene.name, tess_p50, tess_p99, rast_p50, rast_p99, verdict.c_str());
+    }
+
+    return exit_code;
+}
+
+} // namespace Bench
@@ -0,0 +1,49 @@
+#include "bench.h"
+
+#include "input.h"
+
+#include <Windows.h> // bench/win32 off Windows
+
+namespace CatMenu
+{
+// input.cpp's key conversion, used backwards here
+ImGuiKey VirtualKeyToImGuiKey(WPARAM vkKey);
+uint32_t ScanCodeToVK(uint32_t id_code);
+} // namespace CatMenu
+
+namespace Bench
+{
+
+// The scan code the game would report for key, found by running input.cpp's own conversion
+// over every code, so a key comes back out of InputHandler as itself. 0 if no code maps to it.
+static uint32_t ToScanCode(ImGuiKey key)
+{
+    static const auto scan_codes = [] {
+        std::array<uint32_t, ImGuiKey_NamedKey_END> codes{};
+        for (uint32_t code = 0xFF; code > 0; --code) { // the lowest code wins, like the main block over the keypad
+            const auto mapped = CatMenu::VirtualKeyToImGuiKey(CatMenu::ScanCodeToVK(code));
+            if (mapped >= ImGuiKey_NamedKey_BEGIN && mapped < ImGuiKey_NamedKey_END)
+                codes[mapped] = code;
+        }
+        return codes;
+    }();
+    return key >= ImGuiKey_NamedKey_BEGIN && key < ImGuiKey_NamedKey_END ? scan_codes[key] : 0;
+}
+
+// Stands in for the game's input device manager: hands one keyboard event to the hook CatMenu
+// installs on it, which queues it for the thread building frames.
+void QueueKey(ImGuiKey key, bool down)
+{
+    RE::ButtonEvent event;
+    event.device       = RE::INPUT_DEVICE::kKeyboard;
+    event.eventType    = RE::INPUT_EVENT_TYPE::kButton;
+    event.idCode       = ToScanCode(key);
+    event.value        = down ? 1.0f : 0.0f;
+    event.heldDownSecs = down ? 0.0f : 0.1f; // pressed this frame, or released after being held
+
+    RE::BSTEventSource<RE::InputEvent*> source;
+    RE::InputEvent* const               events[] = {&event};
+    CatMenu::InputHandler::BSInputDeviceManager_PollInputDevices::thunk(&source, events);
+}
+
+} // namespace Bench
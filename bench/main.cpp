@@ -0,0 +1,405 @@
+#include "bench.h"
+
+#include "ui.h"
+
+#include <charconv>
+#include <cstdio>
+
+// Headless frame-loop benchmark and checks for UI::Draw, one named case per run.
+//
+// Usage: catmenu_bench [--case sweep|no-alloc|no-alloc-contexts|replay|golden|buffer-sizing]
+//                      [--frames N] [--warmup N] [--plugins 1,10,100,...] [--workload mixed|empty|updated]
+//                      [--update-interval N] [--budget MS] [--pipelined 0|1] [--deadline MS]
+//                      [--refresh-rate HZ] [--contexts 0|1] [--assert-no-alloc 0|1] [--fixed-step MS]
+//                      [--trim-after S] [--trace-hitch MS] [--capture FILE] [--merge 0|1]
+//                      [--backend null|software] [--raster-threads N]
+//                      [--replay FILE] [--golden DIR] [--update-golden 0|1]
+//
+// The case defaults to replay with --replay, golden with --golden and sweep otherwise. Each case
+// prints its own report, then "<case>: ok" or "<case>: FAILED"; a failed or unknown case exits
+// with 1.
+//
+// sweep: for every plugin count the registry is grown to that size, then UI::Draw is run with the
+// menu closed and open; 0 plugins with the menu closed measures the idle path. Reported per
+// frame: CPU time percentiles, heap allocations (global new + ImGui allocator) and the size of
+// the produced draw data. With --assert-no-alloc 1 it fails if any measured frame (i.e. after
+// warm-up) allocated. --fixed-step advances CatMenu's frame clock by that much per frame instead
+// of reading the OS clock, so time-driven behaviour repeats exactly between runs.
+// --trim-after sets how long after the menu closes UI memory is trimmed (off by default, since a
+// trim reallocates); UI memory is printed at the end. --trace-hitch dumps a Chrome trace into the
+// working directory whenever a frame takes longer than that. --capture writes the draw data of
+// the measured frames with the most plugins and the menu open to FILE (which costs time and
+// allocations in those frames). --merge 1 turns on the draw command merge pass (see
+// CatMenu::DrawCmdMerger); the draw calls before and after it are printed at the end. --backend
+// picks the renderer: null (default) only walks the draw data, so frame times are the UI's
+// alone; software rasterizes it on the CPU, on --raster-threads threads (all cores by default).
+// The null backend sizes its (imaginary) vertex and index buffers like the DX11 one; the resizes
+// are printed at the end.
+//
+// no-alloc: sweep with --assert-no-alloc 1. no-alloc-contexts: the same with --contexts 1, every
+// plugin drawn in a context of its own.
+//
+// replay: times the backend on the frames of the capture --replay FILE instead (see
+// Bench::RunReplay). With --merge 1, each captured frame is merged, checked to draw the same
+// triangles as the original (failing if not), and the merged frame is submitted.
+//
+// golden: renders the built-in windows and a notification stack at 1280x720 with the software
+// backend and default settings, prints tessellation and rasterization time percentiles per scene
+// and compares each with its golden image in --golden DIR (see Bench::RunGolden), writing the
+// ones missing, or all of them with --update-golden 1. The frame clock steps 1000/60 ms per frame
+// unless --fixed-step says otherwise, so toasts end up the same every run.
+//
+// buffer-sizing: checks the buffer sizing policy on scripted sessions (see
+// Bench::RunBufferSizing).
+
+struct Options
+{
+    int              frames          = 1000;
+    int              warmup          = 120;
+    std::vector<int> plugins         = {0, 1, 10, 50, 100, 250, 500};
+    Bench::Workload  workload        = Bench::Workload::Mixed;
+    int              update_interval = 1;
+    float            budget_ms       = 0.0f; // frame budget off unless asked for, so runs are comparable
+    int              pipelined       = 0;
+    float            deadline_ms     = 0.0f;
+    int              refresh_rate    = 0;
+    int              contexts        = 0;
+    int              assert_no_alloc = 0;
+    float            fixed_step_ms   = 0.0f;
+    float            trim_after_s    = 0.0f;
+    float            trace_hitch_ms  = 0.0f;
+    int              merge           = 0;
+    int              raster_threads  = 0; // 0 for one per core
+    int              update_golden   = 0;
+    std::string      test_case;
+    std::string      capture;
+    std::string      replay;
+    std::string      golden;
+    std::string      backend         = "null";
+};
+
+struct FrameSample
+{
+    double   us;
+    uint64_t allocs;
+    uint64_t bytes;
+    int      vtx;
+    int      idx;
+    int      cmds;
+};
+
+static Options ParseOptions(int argc, char** argv)
+{
+    Options options;
+
+    auto parse_int = [](std::string_view str, int& out) {
+        std::from_chars(str.data(), str.data() + str.size(), out);
+    };
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string_view arg   = argv[i];
+        std::string_view value = argv[i + 1];
+
+        if (arg == "--case")
+            options.test_case = value;
+        else if (arg == "--frames")
+            parse_int(value, options.frames);
+        else if (arg == "--warmup")
+            parse_int(value, options.warmup);
+        else if (arg == "--plugins") {
+            options.plugins.clear();
+            while (!value.empty()) {
+                auto comma = value.find(',');
+                int  count = -1;
+                parse_int(value.substr(0, comma), count);
+                if (count >= 0)
+                    options.plugins.push_back(count);
+                value = comma == std::string_view::npos ? ""sv : value.substr(comma + 1);
+            }
+            std::ranges::sort(options.plugins);
+        } else if (arg == "--workload")
+            options.workload = value == "empty"   ? Bench::Workload::Empty :
+                               value == "updated" ? Bench::Workload::Updated :
+                                                    Bench::Workload::Mixed;
+        else if (arg == "--update-interval")
+            parse_int(value, options.update_interval);
+        else if (arg == "--pipelined")
+            parse_int(value, options.pipelined);
+        else if (arg == "--budget")
+            std::from_chars(value.data(), value.data() + value.size(), options.budget_ms);
+        else if (arg == "--refresh-rate")
+            parse_int(value, options.refresh_rate);
+        else if (arg == "--contexts")
+            parse_int(value, options.contexts);
+        else if (arg == "--assert-no-alloc")
+            parse_int(value, options.assert_no_alloc);
+        else if (arg == "--deadline")
+            std::from_chars(value.data(), value.data() + value.size(), options.deadline_ms);
+        else if (arg == "--fixed-step")
+            std::from_chars(value.data(), value.data() + value.size(), options.fixed_step_ms);
+        else if (arg == "--trim-after")
+            std::from_chars(value.data(), value.data() + value.size(), options.trim_after_s);
+        else if (arg == "--trace-hitch")
+            std::from_chars(value.data(), value.data() + value.size(), options.trace_hitch_ms);
+        else if (arg == "--merge")
+            parse_int(value, options.merge);
+        else if (arg == "--capture")
+            options.capture = value;
+        else if (arg == "--replay")
+            options.replay = value;
+        else if (arg == "--backend")
+            options.backend = value;
+        else if (arg == "--raster-threads")
+            parse_int(value, options.raster_threads);
+        else if (arg == "--golden")
+            options.golden = value;
+        else if (arg == "--update-golden")
+            parse_int(value, options.update_golden);
+    }
+
+    if (options.test_case.empty())
+        options.test_case = !options.replay.empty() ? "replay" :
+                            !options.golden.empty() ? "golden" :
+                                                      "sweep";
+
+    return options;
+}
+
+static CatMenu::FrameClock::Clock::duration fixed_step;
+static CatMenu::FrameClock::TimePoint       fixed_now;
+static CatMenu::FrameClock::TimePoint FixedStepClock()
+{
+    return fixed_now += fixed_step; // first sample is one step past the epoch
+}
+
+static FrameSample RunFrame()
+{
+    auto ui = CatMenu::UI::GetSingleton();
+
+    auto alloc_before = Bench::GetAllocStats();
+    auto time_before  = std::chrono::steady_clock::now();
+
+    ui->Draw();
+
+    auto time_after  = std::chrono::steady_clock::now();
+    auto alloc_after = Bench::GetAllocStats();
+
+    FrameSample sample{};
+    sample.us     = std::chrono::duration<double, std::micro>(time_after - time_before).count();
+    sample.allocs = alloc_after.count - alloc_before.count;
+    sample.bytes  = alloc_after.bytes - alloc_before.bytes;
+
+    if (auto draw_data = ui->GetSubmittedDrawData()) {
+        sample.vtx = draw_data->TotalVtxCount;
+        sample.idx = draw_data->TotalIdxCount;
+        for (const ImDrawList* cmd_list : draw_data->CmdLists)
+            sample.cmds += cmd_list->CmdBuffer.Size;
+    }
+
+    return sample;
+}
+
+static void SetMenuOpen(bool open)
+{
+    auto ui = CatMenu::UI::GetSingleton();
+    if (ui->IsMenuOpen() == open)
+        return;
+
+    Bench::QueueKey(ImGuiKey_Backslash, true);
+    RunFrame();
+    Bench::QueueKey(ImGuiKey_Backslash, false);
+    RunFrame();
+}
+
+static void Report(int plugins, bool menu_open, std::vector<FrameSample>& samples)
+{
+    std::ranges::sort(samples, {}, &FrameSample::us);
+
+    auto percentile = [&](double p) {
+        return samples[std::min(samples.size() - 1, (size_t)(p * (double)samples.size()))].us;
+    };
+
+    double allocs = 0, bytes = 0, vtx = 0, idx = 0, cmds = 0;
+    for (const auto& sample : samples) {
+        allocs += (double)sample.allocs;
+        bytes += (double)sample.bytes;
+        vtx += sample.vtx;
+        idx += sample.idx;
+        cmds += sample.cmds;
+    }
+    const auto n = (double)samples.size();
+
+    std::printf("%8d %6s %9.1f %9.1f %9.1f %9.1f %10.1f %12.0f %9.0f %9.0f %7.0f\n",
+                plugins, menu_open ? "open" : "closed",
+                percentile(0.5), percentile(0.9), percentile(0.99), samples.back().us,
+                allocs / n, bytes / n, vtx / n, idx / n, cmds / n);
+}
+
+// Sets up CatMenu with backend and the options' settings, ImGui's allocations counted.
+static CatMenu::UI* InitUI(Options& options, std::unique_ptr<CatMenu::RenderBackend> backend)
+{
+    spdlog::set_level(spdlog::level::off);
+    ImGui::SetAllocatorFunctions(Bench::ImGuiAlloc, Bench::ImGuiFree);
+
+    auto ui = CatMenu::UI::GetSingleton();
+    ui->Init(std::move(backend));
+
+    ui->GetSettings().frame_budget_ms      = options.budget_ms;
+    ui->GetSettings().pipelined_ui         = options.pipelined != 0;
+    ui->GetSettings().frame_deadline_ms    = options.deadline_ms;
+    ui->GetSettings().overlay_refresh_rate = options.refresh_rate;
+    ui->GetSettings().trim_after_s         = options.trim_after_s;
+    ui->GetSettings().trace_hitch_ms       = options.trace_hitch_ms;
+    ui->GetSettings().merge_draw_cmds      = options.merge != 0;
+
+    if (options.fixed_step_ms > 0.0f) {
+        fixed_step = std::chrono::duration_cast<CatMenu::FrameClock::Clock::duration>(std::chrono::duration<float, std::milli>(options.fixed_step_ms));
+        ui->GetFrameClock().SetSource(FixedStepClock);
+    }
+    return ui;
+}
+
+static unsigned GetRasterThreads(const Options& options)
+{
+    return options.raster_threads > 0 ? (unsigned)options.raster_threads : std::thread::hardware_concurrency();
+}
+
+static std::unique_ptr<CatMenu::RenderBackend> MakeBackend(const Options& options)
+{
+    if (options.backend == "software")
+        return std::make_unique<CatMenu::SoftwareBackend>(ImVec2{1920.0f, 1080.0f}, GetRasterThreads(options));
+    return std::make_unique<CatMenu::NullBackend>();
+}
+
+static bool RunSweep(Options& options)
+{
+    auto ui = InitUI(options, MakeBackend(options));
+
+    std::printf("%8s %6s %9s %9s %9s %9s %10s %12s %9s %9s %7s\n",
+                "plugins", "menu", "p50(us)", "p90(us)", "p99(us)", "max(us)", "allocs/f", "bytes/f", "vtx/f", "idx/f", "cmds/f");
+
+    std::vector<FrameSample> samples;
+    samples.reserve(options.frames);
+
+    bool passed = true;
+
+    int registered = 0;
+    for (int plugins : options.plugins) {
+        while (registered < plugins)
+            Bench::RegisterPlugin(registered++, options.workload, (uint32_t)std::max(options.update_interval, 1), options.contexts != 0);
+        ImGui::ClearNotifications();
+
+        for (bool menu_open : {false, true}) {
+            SetMenuOpen(menu_open);
+
+            for (int i = 0; i < options.warmup; ++i)
+                RunFrame();
+
+            if (!options.capture.empty() && menu_open && plugins == options.plugins.back())
+                ui->RequestDrawCapture(options.frames, options.capture);
+
+            samples.clear();
+            for (int i = 0; i < options.frames; ++i)
+                samples.push_back(RunFrame());
+
+            Report(plugins, menu_open, samples);
+
+            const auto allocating = std::ranges::count_if(samples, [](const FrameSample& sample) { return sample.allocs != 0; });
+            if (options.assert_no_alloc && allocating) {
+                std::printf("FAIL: %d of %d frames allocated after warm-up (%d plugins, menu %s)\n",
+                            (int)allocating, (int)samples.size(), plugins, menu_open ? "open" : "closed");
+                passed = false;
+            }
+        }
+    }
+
+    if (options.pipelined)
+        std::printf("late frames: %llu, reused frames: %llu\n",
+                    (unsigned long long)ui->GetLateFrameCount(), (unsigned long long)ui->GetReusedFrameCount());
+    std::printf("uploads skipped: %llu of %llu submits\n",
+                (unsigned long long)ui->GetSkippedUploadCount(), (unsigned long long)ui->GetSubmitCount());
+    std::printf("draw calls built: %llu, after merging: %llu\n",
+                (unsigned long long)ui->GetDrawCallCount(), (unsigned long long)ui->GetMergedDrawCallCount());
+    if (auto sizer = ui->GetBackend()->GetBufferSizer())
+        std::printf("buffer resizes: %llu, capacity %d vertices / %d indices, peak %d / %d\n",
+                    (unsigned long long)sizer->GetResizeCount(), sizer->GetVertexCapacity(), sizer->GetIndexCapacity(),
+                    sizer->GetPeakVertices(), sizer->GetPeakIndices());
+    std::printf("ui memory: %.1f KiB\n", ui->GetUIMemory() / 1024.0);
+
+    return passed;
+}
+
+static bool RunNoAlloc(Options& options)
+{
+    options.assert_no_alloc = 1;
+    return RunSweep(options);
+}
+
+static bool RunNoAllocContexts(Options& options)
+{
+    options.contexts = 1;
+    return RunNoAlloc(options);
+}
+
+static bool RunReplayCase(Options& options)
+{
+    if (options.replay.empty()) {
+        std::printf("FAIL: replay needs --replay FILE\n");
+        return false;
+    }
+    auto ui = InitUI(options, MakeBackend(options));
+    return Bench::RunReplay(*ui->GetBackend(), options.replay.c_str(), options.frames, options.warmup, options.merge != 0) == 0;
+}
+
+static bool RunGoldenCase(Options& options)
+{
+    if (options.golden.empty()) {
+        std::printf("FAIL: golden needs --golden DIR\n");
+        return false;
+    }
+    if (options.fixed_step_ms <= 0.0f)
+        options.fixed_step_ms = 1000.0f / 60.0f;
+
+    auto ui      = InitUI(options, std::make_unique<CatMenu::SoftwareBackend>(ImVec2{1280.0f, 720.0f}, GetRasterThreads(options)));
+    auto backend = static_cast<CatMenu::SoftwareBackend*>(ui->GetBackend());
+    return Bench::RunGolden(*backend, options.golden.c_str(), options.update_golden != 0, options.frames, options.warmup) == 0;
+}
+
+static bool RunBufferSizingCase(Options&)
+{
+    return Bench::RunBufferSizing() == 0;
+}
+
+struct Case
+{
+    std::string_view name;
+    bool (*run)(Options& options); // false if the check failed
+};
+
+static constexpr Case g_cases[] = {
+    {"sweep", RunSweep},
+    {"no-alloc", RunNoAlloc},
+    {"no-alloc-contexts", RunNoAllocContexts},
+    {"replay", RunReplayCase},
+    {"golden", RunGoldenCase},
+    {"buffer-sizing", RunBufferSizingCase},
+};
+
+int main(int argc, char** argv)
+{
+    auto options = ParseOptions(argc, argv);
+
+    // one case per run, as they all set up the UI singleton their own way
+    const auto test_case = std::ranges::find(g_cases, options.test_case, &Case::name);
+    if (test_case == std::end(g_cases)) {
+        std::printf("unknown case %s, one of:", options.test_case.c_str());
+        for (const auto& known : g_cases)
+            std::printf(" %.*s", (int)known.name.size(), known.name.data());
+        std::printf("\n");
+        return 1;
+    }
+
+    const bool passed = test_case->run(options);
+    std::printf("%.*s: %s\n", (int)test_case->name.size(), test_case->name.data(), passed ? "ok" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+// Precompiled header for the headless benchmark.
+// Stands in for src/pch.h: provides just enough of CommonLibSSE/SKSE/Win32 for the
+// portable parts of CatMenu (ui.cpp, ImGuiNotify.cpp, input.cpp) to compile on any platform.
+// Off Windows, bench/win32 stands in for the Win32 and DirectInput headers input.cpp includes.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstdarg>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+using namespace std::literals;
+
+namespace logger
+{
+using spdlog::critical;
+using spdlog::debug;
+using spdlog::error;
+using spdlog::info;
+using spdlog::trace;
+using spdlog::warn;
+} // namespace logger
+
+namespace REL
+{
+class Version
+{
+public:
+    constexpr Version() noexcept = default;
+    constexpr Version(std::uint16_t a_v1, std::uint16_t a_v2 = 0, std::uint16_t a_v3 = 0, std::uint16_t a_v4 = 0) noexcept :
+        _impl{a_v1, a_v2, a_v3, a_v4} {}
+
+    [[nodiscard]] constexpr std::uint16_t major() const noexcept { return _impl[0]; }
+    [[nodiscard]] constexpr std::uint16_t minor() const noexcept { return _impl[1]; }
+    [[nodiscard]] constexpr std::uint16_t patch() const noexcept { return _impl[2]; }
+    [[nodiscard]] constexpr std::uint16_t build() const noexcept { return _impl[3]; }
+
+    [[nodiscard]] std::string string() const { return std::format("{}.{}.{}.{}", _impl[0], _impl[1], _impl[2], _impl[3]); }
+
+    constexpr auto operator<=>(const Version&) const noexcept = default;
+
+private:
+    std::array<std::uint16_t, 4> _impl{};
+};
+
+// A hooked game function; calling it does nothing, there is no game to forward to.
+template <class T>
+struct Relocation;
+
+template <class R, class... Args>
+struct Relocation<R(Args...)>
+{
+    R operator()(Args...) const { return R(); }
+};
+} // namespace REL
+
+template <>
+struct std::formatter<REL::Version> : std::formatter<std::string>
+{
+    auto format(const REL::Version& a_version, std::format_context& a_ctx) const
+    {
+        return std::formatter<std::string>::format(a_version.string(), a_ctx);
+    }
+};
+
+namespace RE
+{
+struct INPUT_DEVICES
+{
+    enum INPUT_DEVICE : std::uint32_t
+    {
+        kNone = static_cast<std::uint32_t>(-1),
+        kKeyboard = 0,
+        kMouse,
+        kGamepad,
+    };
+};
+using INPUT_DEVICE = INPUT_DEVICES::INPUT_DEVICE;
+
+enum class INPUT_EVENT_TYPE : std::uint32_t
+{
+    kButton = 0,
+    kMouseMove,
+    kChar,
+    kThumbstick,
+    kDeviceConnect,
+    kKinect,
+    kNone
+};
+
+class ButtonEvent;
+class CharEvent;
+
+class InputEvent
+{
+public:
+    [[nodiscard]] INPUT_DEVICE     GetDevice() const noexcept { return device; }
+    [[nodiscard]] INPUT_EVENT_TYPE GetEventType() const noexcept { return eventType; }
+
+    [[nodiscard]] ButtonEvent* AsButtonEvent();
+    [[nodiscard]] CharEvent*   AsCharEvent();
+
+    INPUT_DEVICE     device    = INPUT_DEVICE::kNone;
+    INPUT_EVENT_TYPE eventType = INPUT_EVENT_TYPE::kNone;
+    InputEvent*      next      = nullptr;
+};
+
+class ButtonEvent : public InputEvent
+{
+public:
+    [[nodiscard]] std::uint32_t GetIDCode() const noexcept { return idCode; }
+    [[nodiscard]] float         Value() const noexcept { return value; }
+    [[nodiscard]] float         HeldDuration() const noexcept { return heldDownSecs; }
+
+    std::uint32_t idCode       = 0;
+    float         value        = 0.0f;
+    float         heldDownSecs = 0.0f;
+};
+
+class CharEvent : public InputEvent
+{
+public:
+    std::uint32_t keyCode = 0;
+};
+
+inline ButtonEvent* InputEvent::AsButtonEvent() { return eventType == INPUT_EVENT_TYPE::kButton ? static_cast<ButtonEvent*>(this) : nullptr; }
+inline CharEvent*   InputEvent::AsCharEvent() { return eventType == INPUT_EVENT_TYPE::kChar ? static_cast<CharEvent*>(this) : nullptr; }
+
+template <class Event>
+class BSTEventSource
+{};
+
+class BSString
+{
+public:
+    BSString(const char* a_str) :
+        _str(a_str) {}
+
+    [[nodiscard]] const char* c_str() const noexcept { return _str.c_str(); }
+    operator std::string_view() const noexcept { return _str; }
+
+private:
+    std::string _str;
+};
+} // namespace RE
+
+namespace SKSE
+{
+class PluginDeclaration
+{
+public:
+    static PluginDeclaration* GetSingleton()
+    {
+        static PluginDeclaration decl;
+        return std::addressof(decl);
+    }
+
+    [[nodiscard]] std::string_view GetName() const noexcept { return "CatMenu"sv; }
+    [[nodiscard]] REL::Version     GetVersion() const noexcept { return {2, 0, 1}; }
+};
+} // namespace SKSE
+
+// Win32/D3D types only appear behind pointers outside of the DX11 backend.
+struct IDXGISwapChain;
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+
+inline void* GetModuleHandle(const wchar_t*) { return nullptr; }
+inline void* GetProcAddress(void*, const char*) { return nullptr; }
+
+#include <ankerl/unordered_dense.h>
+
+struct StringHash
+{
+    using is_transparent = void; // enable heterogeneous overloads
+    using is_avalanching = void; // mark class as high quality avalanching hash
+
+    [[nodiscard]] auto operator()(std::string_view str) const noexcept -> uint64_t
+    {
+        return ankerl::unordered_dense::hash<std::string_view>{}(str);
+    }
+};
+
+template <typename T>
+using StringMap = ankerl::unordered_dense::map<std::string, T, StringHash, std::equal_to<>>;
@@ -0,0 +1,152 @@
+#include "bench.h"
+
+#include "backend.h"
+#include "draw_capture.h"
+#include "draw_data.h"
+#include "draw_hash.h"
+
+namespace Bench
+{
+
+// One element of what a renderer draws, in order: an index's vertex with its command's texture
+// and clip rect, or a callback.
+struct DrawnElement
+{
+    ImTextureID    texture;
+    ImVec4         clip;
+    ImDrawVert     vertex;
+    ImDrawCallback callback;
+};
+
+static void Flatten(const ImDrawData* draw_data, std::vector<DrawnElement>& out)
+{
+    out.clear();
+    for (const ImDrawList* list : draw_data->CmdLists)
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            if (cmd.UserCallback) {
+                out.push_back({nullptr, cmd.ClipRect, {}, cmd.UserCallback});
+                continue;
+            }
+            for (unsigned int i = 0; i < cmd.ElemCount; ++i)
+                out.push_back({cmd.TextureId, cmd.ClipRect, list->VtxBuffer[cmd.VtxOffset + list->IdxBuffer[cmd.IdxOffset + i]], nullptr});
+        }
+}
+
+// Inside the scissor rect a renderer would set for clip, see DrawCmdMerger.
+static bool InScissor(ImVec2 pos, const ImVec4& clip, ImVec2 offset)
+{
+    pos = {pos.x - offset.x, pos.y - offset.y};
+    return pos.x >= std::trunc(clip.x - offset.x) && pos.y >= std::trunc(clip.y - offset.y) &&
+           pos.x <= std::trunc(clip.z - offset.x) && pos.y <= std::trunc(clip.w - offset.y);
+}
+
+// Same elements in the same order; a clip rect may only change where neither rect cuts the vertex.
+static bool DrawsSame(const ImDrawData* original, const ImDrawData* merged)
+{
+    static std::vector<DrawnElement> a, b;
+    Flatten(original, a);
+    Flatten(merged, b);
+    if (a.size() != b.size())
+        return false;
+
+    const ImVec2 offset = original->DisplayPos;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].texture != b[i].texture || a[i].callback != b[i].callback || std::memcmp(&a[i].vertex, &b[i].vertex, sizeof(ImDrawVert)))
+            return false;
+        if (std::memcmp(&a[i].clip, &b[i].clip, sizeof(ImVec4)) &&
+            !(InScissor(a[i].vertex.pos, a[i].clip, offset) && InScissor(b[i].vertex.pos, b[i].clip, offset)))
+            return false;
+    }
+    return true;
+}
+
+int RunReplay(CatMenu::RenderBackend& backend, const char* path, int frames, int warmup, bool merge)
+{
+    CatMenu::DrawCapture capture;
+    if (!capture.Load(path)) {
+        std::printf("failed to load draw capture %s\n", path);
+        return 1;
+    }
+
+    // the captured texture IDs belong to the recording session
+    auto& io = ImGui::GetIO();
+    if (!io.Fonts->TexID)
+        backend.ReCreateFontsTexture();
+    capture.RemapTextures(io.Fonts->TexID);
+
+    // hashed once up front, as UI does when building a frame, so frames equal to the one before
+    // take the backend's retained path
+    const int             count      = capture.GetFrameCount();
+    std::vector<uint64_t> hashes(count);
+    int                   unchanged  = 0;
+    const auto            hash_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+        hashes[i] = CatMenu::HashDrawData(capture.GetFrame(i));
+    const double hash_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - hash_start).count() / count;
+    for (int i = 0; i < count; ++i)
+        unchanged += hashes[i] == hashes[(i + count - 1) % count];
+
+    // merged once per captured frame to check it, before anything is timed
+    CatMenu::DrawCmdMerger merger;
+    uint64_t               calls        = 0;
+    uint64_t               merged_calls = 0;
+    int                    exit_code    = 0;
+    if (merge)
+        for (int i = 0; i < count; ++i) {
+            ImDrawData* original = capture.GetFrame(i);
+            ImDrawData* merged   = merger.Merge(original);
+            calls += CatMenu::CountDrawCalls(original);
+            merged_calls += CatMenu::CountDrawCalls(merged);
+            if (!DrawsSame(original, merged)) {
+                std::printf("FAIL: merged frame %d does not draw the same as the captured one\n", i);
+                exit_code = 1;
+            }
+        }
+
+    // the merge is part of the timed submission; merging is deterministic, so the original's
+    // hash identifies the merged frame just as well
+    auto submit = [&](int i) {
+        ImDrawData* draw_data = capture.GetFrame(i % count);
+        if (merge)
+            draw_data = merger.Merge(draw_data);
+        backend.RenderDrawData(draw_data, hashes[i % count]);
+    };
+
+    for (int i = 0; i < warmup; ++i)
+        submit(i);
+
+    std::vector<double> samples;
+    samples.reserve(frames);
+    for (int i = 0; i < frames; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        submit(i);
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::ranges::sort(samples);
+
+    double lists = 0, cmds = 0, vtx = 0, idx = 0;
+    for (int i = 0; i < count; ++i) {
+        const ImDrawData* draw_data = capture.GetFrame(i);
+        lists += draw_data->CmdListsCount;
+        vtx += draw_data->TotalVtxCount;
+        idx += draw_data->TotalIdxCount;
+        for (const ImDrawList* list : draw_data->CmdLists)
+            cmds += list->CmdBuffer.Size;
+    }
+
+    auto percentile = [&](double p) {
+        return samples[std::min(samples.size() - 1, (size_t)(p * (double)samples.size()))];
+    };
+
+    std::printf("%8s %9s %9s %9s %9s %8s %7s %9s %9s\n",
+                "frames", "p50(us)", "p90(us)", "p99(us)", "max(us)", "lists/f", "cmds/f", "vtx/f", "idx/f");
+    std::printf("%8d %9.1f %9.1f %9.1f %9.1f %8.1f %7.1f %9.0f %9.0f\n",
+                count, percentile(0.5), percentile(0.9), percentile(0.99), samples.back(),
+                lists / count, cmds / count, vtx / count, idx / count);
+    std::printf("hash: %.1f us/frame, %d of %d frames unchanged from the one before\n", hash_us, unchanged, count);
+    if (merge)
+        std::printf("draw calls/f: %.1f captured, %.1f merged\n", (double)calls / count, (double)merged_calls / count);
+    return exit_code;
+}
+
+} // namespace Bench
@@ -0,0 +1,4 @@
+#pragma once
+
+// Off Windows only, see Windows.h.
+#include "Windows.h"
@@ -0,0 +1,97 @@
+#pragma once
+
+// Off Windows only: the Win32 keyboard API input.cpp uses, with a US layout.
+
+#include <cstdint>
+
+using UINT   = unsigned int;
+using DWORD  = std::uint32_t;
+using WPARAM = std::uintptr_t;
+using HKL    = void*;
+
+#define VK_BACK       0x08
+#define VK_TAB        0x09
+#define VK_RETURN     0x0D
+#define VK_PAUSE      0x13
+#define VK_CAPITAL    0x14
+#define VK_ESCAPE     0x1B
+#define VK_SPACE      0x20
+#define VK_PRIOR      0x21
+#define VK_NEXT       0x22
+#define VK_END        0x23
+#define VK_HOME       0x24
+#define VK_LEFT       0x25
+#define VK_UP         0x26
+#define VK_RIGHT      0x27
+#define VK_DOWN       0x28
+#define VK_SNAPSHOT   0x2C
+#define VK_INSERT     0x2D
+#define VK_DELETE     0x2E
+#define VK_LWIN       0x5B
+#define VK_RWIN       0x5C
+#define VK_APPS       0x5D
+#define VK_NUMPAD0    0x60
+#define VK_NUMPAD1    0x61
+#define VK_NUMPAD2    0x62
+#define VK_NUMPAD3    0x63
+#define VK_NUMPAD4    0x64
+#define VK_NUMPAD5    0x65
+#define VK_NUMPAD6    0x66
+#define VK_NUMPAD7    0x67
+#define VK_NUMPAD8    0x68
+#define VK_NUMPAD9    0x69
+#define VK_MULTIPLY   0x6A
+#define VK_ADD        0x6B
+#define VK_SUBTRACT   0x6D
+#define VK_DECIMAL    0x6E
+#define VK_DIVIDE     0x6F
+#define VK_F1         0x70
+#define VK_F2         0x71
+#define VK_F3         0x72
+#define VK_F4         0x73
+#define VK_F5         0x74
+#define VK_F6         0x75
+#define VK_F7         0x76
+#define VK_F8         0x77
+#define VK_F9         0x78
+#define VK_F10        0x79
+#define VK_F11        0x7A
+#define VK_F12        0x7B
+#define VK_NUMLOCK    0x90
+#define VK_SCROLL     0x91
+#define VK_LSHIFT     0xA0
+#define VK_RSHIFT     0xA1
+#define VK_LCONTROL   0xA2
+#define VK_RCONTROL   0xA3
+#define VK_LMENU      0xA4
+#define VK_RMENU      0xA5
+#define VK_OEM_1      0xBA
+#define VK_OEM_PLUS   0xBB
+#define VK_OEM_COMMA  0xBC
+#define VK_OEM_MINUS  0xBD
+#define VK_OEM_PERIOD 0xBE
+#define VK_OEM_2      0xBF
+#define VK_OEM_3      0xC0
+#define VK_OEM_4      0xDB
+#define VK_OEM_5      0xDC
+#define VK_OEM_6      0xDD
+#define VK_OEM_7      0xDE
+
+#define MAPVK_VSC_TO_VK_EX 3
+
+inline HKL GetKeyboardLayout(DWORD) { return nullptr; }
+
+// Set 1 scan codes of the main block; the extended keys DirectInput reports with their own
+// codes are converted by input.cpp before it gets here.
+inline UINT MapVirtualKeyEx(UINT code, UINT map_type, HKL)
+{
+    static constexpr unsigned char vk[0x59] = {
+        0, VK_ESCAPE, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', VK_OEM_MINUS, VK_OEM_PLUS, VK_BACK, VK_TAB,                       // 0x00
+        'Q', 'W', 'E', 'R', 'T', 'Y', 'U', 'I', 'O', 'P', VK_OEM_4, VK_OEM_6, VK_RETURN, VK_LCONTROL, 'A', 'S',                         // 0x10
+        'D', 'F', 'G', 'H', 'J', 'K', 'L', VK_OEM_1, VK_OEM_7, VK_OEM_3, VK_LSHIFT, VK_OEM_5, 'Z', 'X', 'C', 'V',                       // 0x20
+        'B', 'N', 'M', VK_OEM_COMMA, VK_OEM_PERIOD, VK_OEM_2, VK_RSHIFT, VK_MULTIPLY, VK_LMENU, VK_SPACE, VK_CAPITAL, VK_F1, VK_F2, VK_F3, VK_F4, VK_F5, // 0x30
+        VK_F6, VK_F7, VK_F8, VK_F9, VK_F10, VK_NUMLOCK, VK_SCROLL, VK_HOME, VK_UP, VK_PRIOR, VK_SUBTRACT, VK_LEFT, 0, VK_RIGHT, VK_ADD, VK_END, // 0x40
+        VK_DOWN, VK_NEXT, VK_INSERT, VK_DELETE, 0, 0, 0, VK_F11, VK_F12,                                                               // 0x50
+    };
+    return map_type == MAPVK_VSC_TO_VK_EX && code < sizeof(vk) ? vk[code] : 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Off Windows only: the DirectInput scan codes input.cpp converts itself.
+
+#define DIK_NUMPAD7     0x47
+#define DIK_NUMPAD8     0x48
+#define DIK_NUMPAD9     0x49
+#define DIK_NUMPAD4     0x4B
+#define DIK_NUMPAD5     0x4C
+#define DIK_NUMPAD6     0x4D
+#define DIK_NUMPAD1     0x4F
+#define DIK_NUMPAD2     0x50
+#define DIK_NUMPAD3     0x51
+#define DIK_NUMPAD0     0x52
+#define DIK_DECIMAL     0x53
+#define DIK_NUMPADENTER 0x9C
+#define DIK_RCONTROL    0x9D
+#define DIK_RMENU       0xB8
+#define DIK_HOME        0xC7
+#define DIK_UPARROW     0xC8
+#define DIK_PRIOR       0xC9
+#define DIK_LEFTARROW   0xCB
+#define DIK_RIGHTARROW  0xCD
+#define DIK_END         0xCF
+#define DIK_DOWNARROW   0xD0
+#define DIK_NEXT        0xD1
+#define DIK_INSERT      0xD2
+#define DIK_DELETE      0xD3
+#define DIK_LWIN        0xDB
+#define DIK_RWIN        0xDC
+#define DIK_APPS        0xDD
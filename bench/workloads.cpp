@@ -0,0 +1,183 @@
+#include "bench.h"
+
+#include "ui.h"
+
+namespace Bench
+{
+
+// Overlays are spread over a 16x9 grid so windows do not all stack on one spot.
+static ImVec2 GridPos(int index)
+{
+    const auto& io = ImGui::GetIO();
+    return {(float)(index % 16) * io.DisplaySize.x / 16.0f, (float)((index / 16) % 9) * io.DisplaySize.y / 9.0f};
+}
+
+constexpr ImGuiWindowFlags g_overlay_flags =
+    ImGuiWindowFlags_NoDecoration |
+    ImGuiWindowFlags_NoInputs |
+    ImGuiWindowFlags_NoNav |
+    ImGuiWindowFlags_NoSavedSettings |
+    ImGuiWindowFlags_AlwaysAutoResize;
+
+static bool DrawTextHeavy(int index, const char* label)
+{
+    ImGui::SetNextWindowPos(GridPos(index));
+    if (ImGui::Begin(label, nullptr, g_overlay_flags)) {
+        const float t = (float)ImGui::GetTime();
+        for (int i = 0; i < 24; ++i)
+            ImGui::Text("Line %02d  value %8.3f  plugin %d", i, t * (float)(i + 1), index);
+        ImGui::TextWrapped("The quick brown fox jumps over the lazy dog. Sphinx of black quartz, judge my vow.");
+    }
+    ImGui::End();
+    return true;
+}
+
+// The draw func of an updated overlay is a plain function pointer, so the per-plugin state it
+// needs lives in the buffers themselves.
+struct UpdatedBuffer
+{
+    float       values[24] = {};
+    int         index;
+    std::string label;
+};
+
+static void UpdateData(void* back)
+{
+    // stands in for scanning actors or inventories
+    auto  buffer = static_cast<UpdatedBuffer*>(back);
+    float acc    = 0.0f;
+    for (int i = 0; i < 100000; ++i)
+        acc += std::sqrt((float)i);
+    for (int i = 0; i < 24; ++i)
+        buffer->values[i] = acc * (float)(i + 1);
+}
+
+static bool DrawUpdated(const void* front)
+{
+    auto buffer = static_cast<const UpdatedBuffer*>(front);
+
+    ImGui::SetNextWindowPos(GridPos(buffer->index));
+    if (ImGui::Begin(buffer->label.c_str(), nullptr, g_overlay_flags))
+        for (int i = 0; i < 24; ++i)
+            ImGui::Text("Line %02d  value %8.3f  plugin %d", i, buffer->values[i], buffer->index);
+    ImGui::End();
+    return true;
+}
+
+static bool DrawWidgetHeavy(int index, const char* label)
+{
+    static float values[8]  = {};
+    static bool  toggles[8] = {};
+
+    ImGui::SetNextWindowPos(GridPos(index));
+    if (ImGui::Begin(label, nullptr, g_overlay_flags)) {
+        for (int i = 0; i < 8; ++i) {
+            ImGui::PushID(i);
+            ImGui::SliderFloat("##slider", &values[i], 0.0f, 1.0f);
+            ImGui::SameLine();
+            ImGui::Checkbox("##toggle", &toggles[i]);
+            ImGui::ProgressBar(values[i], ImVec2(120.0f, 0.0f));
+            ImGui::SameLine();
+            ImGui::Button("Apply");
+            ImGui::PopID();
+        }
+        if (ImGui::BeginTable("##table", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            for (int row = 0; row < 8; ++row)
+                for (int col = 0; col < 3; ++col) {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d:%d", row, col);
+                }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+    return true;
+}
+
+static bool DrawManyWindows(int index, const char* label)
+{
+    char window_name[64];
+    for (int i = 0; i < 8; ++i) {
+        std::snprintf(window_name, sizeof(window_name), "%s##%d", label, i);
+        auto pos = GridPos(index * 8 + i);
+        ImGui::SetNextWindowPos(pos);
+        if (ImGui::Begin(window_name, nullptr, g_overlay_flags)) {
+            ImGui::TextUnformatted(label);
+            ImGui::Text("%.1f, %.1f", pos.x, pos.y);
+        }
+        ImGui::End();
+    }
+    return true;
+}
+
+static bool DrawMenu(int index, const char* label)
+{
+    bool open = true;
+    ImGui::SetNextWindowPos(GridPos(index), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(320.0f, 240.0f), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin(label, &open)) {
+        if (ImGui::BeginTable("##rows", 2, ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg)) {
+            ImGuiListClipper clipper;
+            clipper.Begin(1000);
+            while (clipper.Step())
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("Entry %d", row);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d", row * index);
+                }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+    return open;
+}
+
+void RegisterPlugin(int index, Workload workload, uint32_t update_interval, bool own_context)
+{
+    auto ui = CatMenu::UI::GetSingleton();
+    if (workload == Workload::Mixed)
+        workload = (Workload)(index % (int)Workload::COUNT);
+
+    auto overlay_name = std::format("Bench Overlay {}", index);
+    auto menu_name    = std::format("Bench Menu {}", index);
+    auto context      = own_context ? ui->CreatePluginContext(std::format("Bench Plugin {}", index)) : nullptr;
+
+    auto add_overlay = [&](std::function<bool()> func) {
+        ui->AddOverlayDrawFunc(overlay_name, std::move(func), update_interval, nullptr, context);
+    };
+    auto add_menu = [&](std::function<bool()> func) {
+        ui->SetDrawFuncEnabled(ui->AddMenuDrawFunc(menu_name, std::move(func), context), true);
+    };
+
+    if (workload == Workload::Empty) {
+        add_overlay([]() { return true; });
+        add_menu([]() { return true; });
+        return;
+    }
+
+    if (workload == Workload::Updated) {
+        auto buffers = new UpdatedBuffer[2]{{{}, index, overlay_name}, {{}, index, overlay_name}}; // lives as long as the bench
+        ui->AddUpdatedOverlayDrawFunc(overlay_name, UpdateData, DrawUpdated, &buffers[0], &buffers[1], update_interval);
+        add_menu([index, label = menu_name]() { return DrawMenu(index, label.c_str()); });
+        return;
+    }
+
+    switch (workload) {
+        case Workload::TextHeavy:
+            add_overlay([index, label = overlay_name]() { return DrawTextHeavy(index, label.c_str()); });
+            break;
+        case Workload::WidgetHeavy:
+            add_overlay([index, label = overlay_name]() { return DrawWidgetHeavy(index, label.c_str()); });
+            break;
+        case Workload::ManyWindows:
+            add_overlay([index, label = overlay_name]() { return DrawManyWindows(index, label.c_str()); });
+            break;
+        default:
+            break;
+    }
+
+    add_menu([index, label = menu_name]() { return DrawMenu(index, label.c_str()); });
+}
+
+} // namespace Bench
@@ -54,6 +54,7 @@ void InsertNotification(const ImGuiToast& toast)
 {
     std::lock_guard lock(notification_mutex);
     notifications.push_back(toast);
+    notifications.back().setCreationTime({}); // plugins built against older headers stamp it with system_clock
 }
 
 /**
@@ -67,12 +68,57 @@ void RemoveNotification(int index)
     notifications.erase(notifications.begin() + index);
 }
 
+/**
+     * @brief Removes all notifications.
+     */
+void ClearNotifications()
+{
+    std::lock_guard lock(notification_mutex);
+    notifications.clear();
+}
+
+/**
+     * @brief Checks whether any notification is waiting to be rendered.
+     */
+bool HasNotifications()
+{
+    std::lock_guard lock(notification_mutex);
+    return !notifications.empty();
+}
+
+/**
+     * @brief Returns the number of notifications waiting to be rendered or being shown.
+     */
+size_t GetNotificationCount()
+{
+    std::lock_guard lock(notification_mutex);
+    return notifications.size();
+}
+
+/**
+     * @brief Shrinks the notification queue to the toasts it holds.
+     */
+void ShrinkNotifications()
+{
+    std::lock_guard lock(notification_mutex);
+    notifications.shrink_to_fit();
+}
+
+/**
+     * @brief Returns the heap memory held by the notification queue, in bytes.
+     */
+size_t GetNotificationMemory()
+{
+    std::lock_guard lock(notification_mutex);
+    return notifications.capacity() * sizeof(ImGuiToast);
+}
+
 /**
      * Renders all notifications in the notifications vector.
      * Each notification is rendered as a toast window with a title, content and an optional icon.
      * If a notification is expired, it is removed from the vector.
      */
-void RenderNotifications()
+void RenderNotifications(std::chrono::steady_clock::time_point now)
 {
     std::lock_guard lock(notification_mutex);
 
@@ -80,15 +126,19 @@ void RenderNotifications()
 
     float height = 0.f;
 
+    // Remove expired toasts up front; erasing while iterating skipped the toast after each one
+    // Toasts start their timer on the first frame they are shown, so ones inserted while nothing
+    // is rendered (e.g. during loading) are not missed
+    for (auto& toast : notifications)
+        if (toast.isPending())
+            toast.setCreationTime(now);
+    std::erase_if(notifications, [now](ImGuiToast& toast) { return toast.getPhase(now) == ImGuiToastPhase::Expired; });
+
+    size_t dismissed = notifications.size();
+
     for (size_t i = 0; i < notifications.size(); ++i) {
         ImGuiToast* currentToast = &notifications[i];
 
-        // Remove toast if expired
-        if (currentToast->getPhase() == ImGuiToastPhase::Expired) {
-            notifications.erase(notifications.begin() + i);
-            continue;
-        }
-
 #if NOTIFY_RENDER_LIMIT > 0
         if (i > NOTIFY_RENDER_LIMIT) {
             continue;
@@ -100,7 +150,7 @@ void RenderNotifications()
         const char* title        = currentToast->getTitle();
         const char* content      = currentToast->getContent();
         const char* defaultTitle = currentToast->getDefaultTitle();
-        const float opacity      = currentToast->getFadePercent(); // Get opacity based of the current phase
+        const float opacity      = currentToast->getFadePercent(now); // Get opacity based of the current phase
 
         // Window rendering
         ImVec4 textColor = currentToast->getColor();
@@ -191,9 +241,9 @@ void RenderNotifications()
 
                 SetCursorPosX(GetCursorPosX() + (GetWindowSize().x - GetCursorPosX()) * scale);
 
-                // If the button is pressed, we want to remove the notification
+                // If the button is pressed, we want to remove the notification (after the loop, currentToast is still in use)
                 if (Button(ICON_FA_XMARK)) {
-                    notifications.erase(notifications.begin() + i);
+                    dismissed = i;
                 }
             }
 
@@ -230,6 +280,9 @@ void RenderNotifications()
         // End
         End();
     }
+
+    if (dismissed < notifications.size())
+        notifications.erase(notifications.begin() + dismissed);
 }
 } // namespace ImGui
 
@@ -135,7 +135,7 @@ private:
     char           content[NOTIFY_MAX_MSG_LENGTH];
 
     int                                   dismissTime  = NOTIFY_DEFAULT_DISMISS;
-    std::chrono::system_clock::time_point creationTime = std::chrono::system_clock::now();
+    std::chrono::steady_clock::time_point creationTime{}; // stamped with CatMenu's frame clock when first rendered
 
     std::function<void()> onButtonPress = nullptr; // A lambda variable, which will be executed when button in notification is pressed
     char                  buttonLabel[NOTIFY_MAX_MSG_LENGTH];
@@ -223,9 +223,29 @@ public:
         NOTIFY_FORMAT(this->setButtonLabel, format);
     }
 
+    /**
+     * @brief Set the time the notification's fade in starts.
+     * 
+     * @param creationTime A time of CatMenu's frame clock, or an empty time point to start on the next rendered frame.
+    */
+    inline void setCreationTime(std::chrono::steady_clock::time_point creationTime)
+    {
+        this->creationTime = creationTime;
+    }
+
 public:
     // Getters
 
+    /**
+     * @brief Whether the notification has not been rendered yet.
+     * 
+     * @return bool True until the notification's timer was started.
+     */
+    inline bool isPending()
+    {
+        return this->creationTime == std::chrono::steady_clock::time_point{};
+    }
+
     /**
      * @brief Get the title of the toast notification.
      * 
@@ -330,28 +350,29 @@ public:
     };
 
     /**
-     * @brief Get the elapsed time in milliseconds since the creation of the object.
+     * @brief Get the elapsed time since the notification was first rendered.
      * 
-     * @return int64_t The elapsed time in milliseconds.
-     * @throws An exception with the message "Unsupported platform" if the platform is not supported.
+     * @param now The time of the current frame.
+     * @return std::chrono::nanoseconds The elapsed time.
      */
-    inline std::chrono::nanoseconds getElapsedTime()
+    inline std::chrono::nanoseconds getElapsedTime(std::chrono::steady_clock::time_point now)
     {
-        return std::chrono::system_clock::now() - this->creationTime;
+        return now - this->creationTime;
     }
 
     /**
      * @brief Get the current phase of the toast notification based on the elapsed time since its creation.
      * 
+     * @param now The time of the current frame.
      * @return ImGuiToastPhase The current phase of the toast notification.
      *         - ImGuiToastPhase::FadeIn: The notification is fading in.
      *         - ImGuiToastPhase::Wait: The notification is waiting to be dismissed.
      *         - ImGuiToastPhase::FadeOut: The notification is fading out.
      *         - ImGuiToastPhase::Expired: The notification has expired and should be removed.
      */
-    inline ImGuiToastPhase getPhase()
+    inline ImGuiToastPhase getPhase(std::chrono::steady_clock::time_point now)
     {
-        const int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(getElapsedTime()).count();
+        const int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(getElapsedTime(now)).count();
 
         if (elapsed > NOTIFY_FADE_IN_OUT_TIME + this->dismissTime + NOTIFY_FADE_IN_OUT_TIME) {
             return ImGuiToastPhase::Expired;
@@ -366,12 +387,13 @@ public:
 
     /**
      * Returns the percentage of fade for the notification.
+     * @param now The time of the current frame.
      * @return The percentage of fade for the notification.
      */
-    inline float getFadePercent()
+    inline float getFadePercent(std::chrono::steady_clock::time_point now)
     {
-        const ImGuiToastPhase phase   = getPhase();
-        const int64_t         elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(getElapsedTime()).count();
+        const ImGuiToastPhase phase   = getPhase(now);
+        const int64_t         elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(getElapsedTime(now)).count();
 
         if (phase == ImGuiToastPhase::FadeIn) {
             return ((float)elapsed / (float)NOTIFY_FADE_IN_OUT_TIME) * NOTIFY_OPACITY;
@@ -422,8 +444,6 @@ public:
         this->type        = type;
         this->dismissTime = dismissTime;
 
-        this->creationTime = std::chrono::system_clock::now();
-
         memset(this->title, 0, sizeof(this->title));
         memset(this->content, 0, sizeof(this->content));
     }
@@ -477,9 +497,14 @@ public:
 
 namespace ImGui
 {
-void InsertNotification(const ImGuiToast& toast);
-void RemoveNotification(int index);
-void RenderNotifications();
+void   InsertNotification(const ImGuiToast& toast);
+void   RemoveNotification(int index);
+void   ClearNotifications();
+bool   HasNotifications();
+size_t GetNotificationCount();
+void   ShrinkNotifications();   // releases the capacity left over from a burst of toasts
+size_t GetNotificationMemory(); // heap held by the queue, in bytes
+void   RenderNotifications(std::chrono::steady_clock::time_point now); // now: time of the current frame
 } // namespace ImGui
 
 #endif
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "buffer_sizer.h"
+#include "imgui.h"
+
+namespace CatMenu
+{
+
+class WorkerPool;
+
+// Platform/renderer glue used by UI, which owns one. The game runs DX11Backend; the headless
+// benchmark picks NullBackend or SoftwareBackend, so the frame loop and the renderer can be
+// measured apart.
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual const char* GetName() const = 0;
+
+    // Once, on the newly created ImGui context that is current.
+    virtual void Init() = 0;
+
+    // Before ImGui::NewFrame: display size and platform state, and the font texture if missing.
+    virtual void NewFrame() = 0;
+
+    // hash is HashDrawData(draw_data), or 0 if unknown. When it matches the last frame uploaded,
+    // the vertex and index buffers still hold the frame and are not uploaded again. Returns
+    // whether they were reused.
+    virtual bool RenderDrawData(ImDrawData* draw_data, uint64_t hash) = 0;
+
+    // After the font atlas is rebuilt.
+    virtual void ReCreateFontsTexture() = 0;
+
+    // Sizes the vertex and index buffers the draw data is uploaded to; nullptr if there are none.
+    virtual BufferSizer* GetBufferSizer() { return nullptr; }
+};
+
+// imgui_impl_win32 for the platform, and a DX11 renderer of CatMenu's own on the game's swapchain:
+// shaders, states, font texture and the vertex and index buffers, created at the sizes
+// BufferSizer picks. Owning the buffers lets an unchanged frame be drawn again without uploading
+// it. Game build only.
+class DX11Backend : public RenderBackend, private BufferDevice
+{
+public:
+    DX11Backend(IDXGISwapChain* swapchain, ID3D11Device* device, ID3D11DeviceContext* context);
+    ~DX11Backend() override;
+
+    const char*  GetName() const override { return "dx11"; }
+    void         Init() override;
+    void         NewFrame() override;
+    bool         RenderDrawData(ImDrawData* draw_data, uint64_t hash) override;
+    void         ReCreateFontsTexture() override;
+    BufferSizer* GetBufferSizer() override { return &buffer_sizer; }
+
+private:
+    struct SavedState;
+
+    bool CreateDeviceObjects();
+    bool Upload(const ImDrawData* draw_data, uint64_t hash); // false if the buffers could not be written
+    void SetupRenderState(const ImDrawData* draw_data);
+    void Draw(const ImDrawData* draw_data); // from what the buffers hold
+    bool CreateBuffer(ID3D11Buffer*& buffer, int capacity, UINT element_size, UINT bind_flags);
+
+    bool ResizeVertexBuffer(int capacity) override;
+    bool ResizeIndexBuffer(int capacity) override;
+
+    IDXGISwapChain*      swapchain;
+    ID3D11Device*        device;
+    ID3D11DeviceContext* context;
+
+    ID3D11VertexShader*       vertex_shader       = nullptr;
+    ID3D11InputLayout*        input_layout        = nullptr;
+    ID3D11Buffer*             constant_buffer     = nullptr; // projection
+    ID3D11PixelShader*        pixel_shader        = nullptr;
+    ID3D11RasterizerState*    rasterizer_state    = nullptr;
+    ID3D11BlendState*         blend_state         = nullptr;
+    ID3D11DepthStencilState*  depth_stencil_state = nullptr;
+    ID3D11SamplerState*       sampler             = nullptr;
+    ID3D11ShaderResourceView* font_view           = nullptr; // the font atlas' texture ID
+    ID3D11Buffer*             vertex_buffer       = nullptr; // nullptr until the first upload, or if creating it failed
+    ID3D11Buffer*             index_buffer        = nullptr;
+
+    uint64_t    uploaded_hash = 0; // of the frame the vertex and index buffers hold
+    BufferSizer buffer_sizer{*this};
+};
+
+// Fixed display size and frame rate, nothing is uploaded anywhere: draw data is only walked, so
+// only the cost of producing it is measured. Retained frames and buffer sizes are tracked like
+// DX11Backend does, so reuse rates and resizes can be measured.
+class NullBackend : public RenderBackend, private BufferDevice
+{
+public:
+    explicit NullBackend(ImVec2 display_size = {1920.0f, 1080.0f});
+
+    const char*  GetName() const override { return "null"; }
+    void         Init() override;
+    void         NewFrame() override;
+    bool         RenderDrawData(ImDrawData* draw_data, uint64_t hash) override;
+    void         ReCreateFontsTexture() override;
+    BufferSizer* GetBufferSizer() override { return &buffer_sizer; }
+
+private:
+    // no buffers to create, BufferSizer counts the resizes
+    bool ResizeVertexBuffer(int) override { return true; }
+    bool ResizeIndexBuffer(int) override { return true; }
+
+    ImVec2      display_size;
+    int         font_texture  = 0; // its address is the font atlas' texture ID
+    uint64_t    uploaded_hash = 0;
+    BufferSizer buffer_sizer{*this};
+};
+
+// Rasterizes draw data on the CPU into a framebuffer of its own, cleared to transparent every
+// frame, blending like imgui_impl_dx11 does. For headless runs that need the pixels or the cost
+// of filling them. Textures sample nearest; IDs other than the font atlas' sample as white, and
+// user callbacks are skipped, since they expect the game's renderer.
+// The framebuffer is split into bands of rows, rasterized in parallel by threads (the calling
+// one included), each drawing every triangle that reaches its band in submission order.
+class SoftwareBackend : public RenderBackend
+{
+public:
+    explicit SoftwareBackend(ImVec2 display_size = {1920.0f, 1080.0f}, unsigned threads = std::thread::hardware_concurrency());
+    ~SoftwareBackend() override;
+
+    const char* GetName() const override { return "software"; }
+    void        Init() override;
+    void        NewFrame() override;
+    bool        RenderDrawData(ImDrawData* draw_data, uint64_t hash) override;
+    void        ReCreateFontsTexture() override;
+
+    // RGBA, 8 bits per channel, rows top to bottom. Holds the last frame rendered.
+    int             GetWidth() const { return width; }
+    int             GetHeight() const { return height; }
+    const uint32_t* GetPixels() const { return framebuffer.data(); }
+
+private:
+    struct Texture
+    {
+        int                   width  = 0;
+        int                   height = 0;
+        std::vector<uint32_t> pixels;
+    };
+
+    struct Triangle
+    {
+        const ImDrawVert* verts[3];
+        const Texture*    texture;
+        int               x0, y0, x1, y1; // pixels to test: the scissor rect within the bounds, x1 and y1 exclusive
+    };
+
+    static constexpr int BandHeight = 32;
+
+    void        DrawTriangle(const Triangle& triangle, int band_y0, int band_y1);
+    void        RasterizeBands(); // claims bands until none are left
+    static void RasterizeTask(void* backend);
+
+    int                   width;
+    int                   height;
+    std::vector<uint32_t> framebuffer;
+    Texture               font;
+    uint64_t              drawn_hash = 0; // of the frame the framebuffer holds
+
+    // the frame being rasterized
+    std::vector<Triangle> triangles; // in submission order, capacity kept across frames
+    ImVec2                offset;    // DisplayPos
+    std::atomic<int>      next_band = 0;
+    std::atomic<int>      helpers   = 0; // tasks still running; the frame is done at 0
+
+    unsigned                    helper_count = 0;
+    std::unique_ptr<WorkerPool> workers; // declared last, so it is joined first; nullptr with one thread
+};
+
+} // namespace CatMenu
@@ -0,0 +1,492 @@
+#include "backend.h"
+
+#include <d3dcompiler.h>
+#include <imgui_impl_win32.h>
+
+namespace CatMenu
+{
+
+// ImGui's stock shaders: vertex colour times the texture, in an orthographic projection of the
+// display rect.
+constexpr auto g_vertex_shader = R"(
+cbuffer vertexBuffer : register(b0)
+{
+    float4x4 ProjectionMatrix;
+};
+struct VS_INPUT
+{
+    float2 pos : POSITION;
+    float4 col : COLOR0;
+    float2 uv  : TEXCOORD0;
+};
+struct PS_INPUT
+{
+    float4 pos : SV_POSITION;
+    float4 col : COLOR0;
+    float2 uv  : TEXCOORD0;
+};
+PS_INPUT main(VS_INPUT input)
+{
+    PS_INPUT output;
+    output.pos = mul(ProjectionMatrix, float4(input.pos.xy, 0.f, 1.f));
+    output.col = input.col;
+    output.uv  = input.uv;
+    return output;
+}
+)"sv;
+
+constexpr auto g_pixel_shader = R"(
+struct PS_INPUT
+{
+    float4 pos : SV_POSITION;
+    float4 col : COLOR0;
+    float2 uv  : TEXCOORD0;
+};
+sampler sampler0;
+Texture2D texture0;
+float4 main(PS_INPUT input) : SV_Target
+{
+    return input.col * texture0.Sample(sampler0, input.uv);
+}
+)"sv;
+
+template <class T>
+static void Release(T*& object)
+{
+    if (object) {
+        object->Release();
+        object = nullptr;
+    }
+}
+
+static ID3DBlob* CompileShader(std::string_view source, const char* target)
+{
+    ID3DBlob* blob   = nullptr;
+    ID3DBlob* errors = nullptr;
+    if (FAILED(D3DCompile(source.data(), source.size(), nullptr, nullptr, nullptr, "main", target, 0, 0, &blob, &errors))) {
+        logger::error("Failed to compile the {} shader: {}", target, errors ? (const char*)errors->GetBufferPointer() : "unknown error");
+        Release(errors);
+        return nullptr;
+    }
+    Release(errors);
+    return blob;
+}
+
+// The pipeline state RenderDrawData changes, restored afterwards so the game's own rendering
+// carries on as it was.
+struct DX11Backend::SavedState
+{
+    UINT                      scissor_count  = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+    UINT                      viewport_count = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+    D3D11_RECT                scissor_rects[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    D3D11_VIEWPORT            viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    ID3D11RasterizerState*    rasterizer_state = nullptr;
+    ID3D11BlendState*         blend_state      = nullptr;
+    FLOAT                     blend_factor[4];
+    UINT                      sample_mask;
+    ID3D11DepthStencilState*  depth_stencil_state = nullptr;
+    UINT                      stencil_ref;
+    ID3D11ShaderResourceView* ps_resource = nullptr;
+    ID3D11SamplerState*       ps_sampler  = nullptr;
+    ID3D11PixelShader*        ps          = nullptr;
+    ID3D11VertexShader*       vs          = nullptr;
+    ID3D11GeometryShader*     gs          = nullptr;
+    ID3D11ClassInstance*      ps_instances[256]; // the most PSSetShader takes
+    ID3D11ClassInstance*      vs_instances[256];
+    ID3D11ClassInstance*      gs_instances[256];
+    UINT                      ps_instance_count  = 256;
+    UINT                      vs_instance_count  = 256;
+    UINT                      gs_instance_count  = 256;
+    ID3D11Buffer*             vs_constant_buffer = nullptr;
+    D3D11_PRIMITIVE_TOPOLOGY  topology;
+    ID3D11Buffer*             index_buffer = nullptr;
+    DXGI_FORMAT               index_format;
+    UINT                      index_offset;
+    ID3D11Buffer*             vertex_buffer = nullptr;
+    UINT                      vertex_stride;
+    UINT                      vertex_offset;
+    ID3D11InputLayout*        input_layout = nullptr;
+
+    explicit SavedState(ID3D11DeviceContext* context)
+    {
+        context->RSGetScissorRects(&scissor_count, scissor_rects);
+        context->RSGetViewports(&viewport_count, viewports);
+        context->RSGetState(&rasterizer_state);
+        context->OMGetBlendState(&blend_state, blend_factor, &sample_mask);
+        context->OMGetDepthStencilState(&depth_stencil_state, &stencil_ref);
+        context->PSGetShaderResources(0, 1, &ps_resource);
+        context->PSGetSamplers(0, 1, &ps_sampler);
+        context->PSGetShader(&ps, ps_instances, &ps_instance_count);
+        context->VSGetShader(&vs, vs_instances, &vs_instance_count);
+        context->VSGetConstantBuffers(0, 1, &vs_constant_buffer);
+        context->GSGetShader(&gs, gs_instances, &gs_instance_count);
+        context->IAGetPrimitiveTopology(&topology);
+        context->IAGetIndexBuffer(&index_buffer, &index_format, &index_offset);
+        context->IAGetVertexBuffers(0, 1, &vertex_buffer, &vertex_stride, &vertex_offset);
+        context->IAGetInputLayout(&input_layout);
+    }
+
+    // The getters add a reference to everything they return, dropped again here.
+    void Restore(ID3D11DeviceContext* context)
+    {
+        context->RSSetScissorRects(scissor_count, scissor_rects);
+        context->RSSetViewports(viewport_count, viewports);
+        context->RSSetState(rasterizer_state);
+        context->OMSetBlendState(blend_state, blend_factor, sample_mask);
+        context->OMSetDepthStencilState(depth_stencil_state, stencil_ref);
+        context->PSSetShaderResources(0, 1, &ps_resource);
+        context->PSSetSamplers(0, 1, &ps_sampler);
+        context->PSSetShader(ps, ps_instances, ps_instance_count);
+        context->VSSetShader(vs, vs_instances, vs_instance_count);
+        context->VSSetConstantBuffers(0, 1, &vs_constant_buffer);
+        context->GSSetShader(gs, gs_instances, gs_instance_count);
+        context->IASetPrimitiveTopology(topology);
+        context->IASetIndexBuffer(index_buffer, index_format, index_offset);
+        context->IASetVertexBuffers(0, 1, &vertex_buffer, &vertex_stride, &vertex_offset);
+        context->IASetInputLayout(input_layout);
+
+        Release(rasterizer_state);
+        Release(blend_state);
+        Release(depth_stencil_state);
+        Release(ps_resource);
+        Release(ps_sampler);
+        Release(ps);
+        Release(vs);
+        Release(gs);
+        for (UINT i = 0; i < ps_instance_count; ++i)
+            Release(ps_instances[i]);
+        for (UINT i = 0; i < vs_instance_count; ++i)
+            Release(vs_instances[i]);
+        for (UINT i = 0; i < gs_instance_count; ++i)
+            Release(gs_instances[i]);
+        Release(vs_constant_buffer);
+        Release(index_buffer);
+        Release(vertex_buffer);
+        Release(input_layout);
+    }
+};
+
+DX11Backend::DX11Backend(IDXGISwapChain* swapchain, ID3D11Device* device, ID3D11DeviceContext* context) :
+    swapchain(swapchain), device(device), context(context)
+{
+}
+
+DX11Backend::~DX11Backend()
+{
+    Release(vertex_buffer);
+    Release(index_buffer);
+    Release(font_view);
+    Release(sampler);
+    Release(depth_stencil_state);
+    Release(blend_state);
+    Release(rasterizer_state);
+    Release(pixel_shader);
+    Release(constant_buffer);
+    Release(input_layout);
+    Release(vertex_shader);
+}
+
+void DX11Backend::Init()
+{
+    DXGI_SWAP_CHAIN_DESC desc;
+    swapchain->GetDesc(&desc);
+    ImGui_ImplWin32_Init(desc.OutputWindow);
+
+    auto& io               = ImGui::GetIO();
+    io.BackendRendererName = "catmenu_dx11_renderer";
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+    if (!CreateDeviceObjects())
+        logger::error("Failed to create the DX11 renderer's device objects, nothing will be drawn.");
+}
+
+bool DX11Backend::CreateDeviceObjects()
+{
+    auto vs_blob = CompileShader(g_vertex_shader, "vs_4_0");
+    if (!vs_blob)
+        return false;
+    const bool vs_created = SUCCEEDED(device->CreateVertexShader(vs_blob->GetBufferPointer(), vs_blob->GetBufferSize(), nullptr, &vertex_shader));
+
+    const D3D11_INPUT_ELEMENT_DESC layout[] = {
+        {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, (UINT)offsetof(ImDrawVert, pos), D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, (UINT)offsetof(ImDrawVert, uv), D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, (UINT)offsetof(ImDrawVert, col), D3D11_INPUT_PER_VERTEX_DATA, 0},
+    };
+    const bool layout_created = vs_created &&
+                                SUCCEEDED(device->CreateInputLayout(layout, 3, vs_blob->GetBufferPointer(), vs_blob->GetBufferSize(), &input_layout));
+    Release(vs_blob);
+    if (!layout_created)
+        return false;
+
+    auto ps_blob = CompileShader(g_pixel_shader, "ps_4_0");
+    if (!ps_blob)
+        return false;
+    const bool ps_created = SUCCEEDED(device->CreatePixelShader(ps_blob->GetBufferPointer(), ps_blob->GetBufferSize(), nullptr, &pixel_shader));
+    Release(ps_blob);
+    if (!ps_created)
+        return false;
+
+    D3D11_BUFFER_DESC cb_desc{};
+    cb_desc.ByteWidth      = sizeof(float) * 16;
+    cb_desc.Usage          = D3D11_USAGE_DYNAMIC;
+    cb_desc.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
+    cb_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    if (FAILED(device->CreateBuffer(&cb_desc, nullptr, &constant_buffer)))
+        return false;
+
+    // straight alpha over the game's frame
+    D3D11_BLEND_DESC blend_desc{};
+    auto&            target      = blend_desc.RenderTarget[0];
+    target.BlendEnable           = true;
+    target.SrcBlend              = D3D11_BLEND_SRC_ALPHA;
+    target.DestBlend             = D3D11_BLEND_INV_SRC_ALPHA;
+    target.BlendOp               = D3D11_BLEND_OP_ADD;
+    target.SrcBlendAlpha         = D3D11_BLEND_ONE;
+    target.DestBlendAlpha        = D3D11_BLEND_INV_SRC_ALPHA;
+    target.BlendOpAlpha          = D3D11_BLEND_OP_ADD;
+    target.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+    if (FAILED(device->CreateBlendState(&blend_desc, &blend_state)))
+        return false;
+
+    D3D11_RASTERIZER_DESC rasterizer_desc{};
+    rasterizer_desc.FillMode        = D3D11_FILL_SOLID;
+    rasterizer_desc.CullMode        = D3D11_CULL_NONE;
+    rasterizer_desc.ScissorEnable   = true;
+    rasterizer_desc.DepthClipEnable = true;
+    if (FAILED(device->CreateRasterizerState(&rasterizer_desc, &rasterizer_state)))
+        return false;
+
+    D3D11_DEPTH_STENCIL_DESC depth_desc{};
+    depth_desc.DepthEnable                  = false;
+    depth_desc.DepthWriteMask               = D3D11_DEPTH_WRITE_MASK_ALL;
+    depth_desc.DepthFunc                    = D3D11_COMPARISON_ALWAYS;
+    depth_desc.StencilEnable                = false;
+    depth_desc.FrontFace.StencilFailOp      = D3D11_STENCIL_OP_KEEP;
+    depth_desc.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_KEEP;
+    depth_desc.FrontFace.StencilPassOp      = D3D11_STENCIL_OP_KEEP;
+    depth_desc.FrontFace.StencilFunc        = D3D11_COMPARISON_ALWAYS;
+    depth_desc.BackFace                     = depth_desc.FrontFace;
+    if (FAILED(device->CreateDepthStencilState(&depth_desc, &depth_stencil_state)))
+        return false;
+
+    // bilinear, which the atlas' baked anti-aliased lines rely on
+    D3D11_SAMPLER_DESC sampler_desc{};
+    sampler_desc.Filter         = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    sampler_desc.AddressU       = D3D11_TEXTURE_ADDRESS_WRAP;
+    sampler_desc.AddressV       = D3D11_TEXTURE_ADDRESS_WRAP;
+    sampler_desc.AddressW       = D3D11_TEXTURE_ADDRESS_WRAP;
+    sampler_desc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+    return SUCCEEDED(device->CreateSamplerState(&sampler_desc, &sampler));
+}
+
+void DX11Backend::NewFrame()
+{
+    ImGui_ImplWin32_NewFrame();
+
+    if (!font_view)
+        ReCreateFontsTexture();
+}
+
+bool DX11Backend::RenderDrawData(ImDrawData* draw_data, uint64_t hash)
+{
+    // minimized, or without device objects; the buffers keep what they hold
+    if (draw_data->DisplaySize.x <= 0.0f || draw_data->DisplaySize.y <= 0.0f || !pixel_shader || !sampler)
+        return false;
+
+    // the buffers still hold the frame
+    const bool retained = hash && hash == uploaded_hash;
+    if (!retained && !Upload(draw_data, hash))
+        return false;
+
+    Draw(draw_data);
+    return retained;
+}
+
+bool DX11Backend::Upload(const ImDrawData* draw_data, uint64_t hash)
+{
+    uploaded_hash = 0;
+
+    buffer_sizer.Reserve(draw_data->TotalVtxCount, draw_data->TotalIdxCount);
+    if (!vertex_buffer || !index_buffer) // could not be created, tried again next frame
+        return false;
+
+    D3D11_MAPPED_SUBRESOURCE vertices, indices;
+    if (FAILED(context->Map(vertex_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &vertices)))
+        return false;
+    if (FAILED(context->Map(index_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &indices))) {
+        context->Unmap(vertex_buffer, 0);
+        return false;
+    }
+
+    auto vtx_dst = (ImDrawVert*)vertices.pData;
+    auto idx_dst = (ImDrawIdx*)indices.pData;
+    for (const ImDrawList* cmd_list : draw_data->CmdLists) {
+        std::memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.size_in_bytes());
+        std::memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.size_in_bytes());
+        vtx_dst += cmd_list->VtxBuffer.Size;
+        idx_dst += cmd_list->IdxBuffer.Size;
+    }
+
+    context->Unmap(vertex_buffer, 0);
+    context->Unmap(index_buffer, 0);
+
+    uploaded_hash = hash;
+    return true;
+}
+
+void DX11Backend::SetupRenderState(const ImDrawData* draw_data)
+{
+    D3D11_VIEWPORT viewport{};
+    viewport.Width    = draw_data->DisplaySize.x;
+    viewport.Height   = draw_data->DisplaySize.y;
+    viewport.MaxDepth = 1.0f;
+    context->RSSetViewports(1, &viewport);
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (SUCCEEDED(context->Map(constant_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        const float l = draw_data->DisplayPos.x;
+        const float r = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+        const float t = draw_data->DisplayPos.y;
+        const float b = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+
+        const float projection[4][4] = {
+            {2.0f / (r - l), 0.0f, 0.0f, 0.0f},
+            {0.0f, 2.0f / (t - b), 0.0f, 0.0f},
+            {0.0f, 0.0f, 0.5f, 0.0f},
+            {(r + l) / (l - r), (t + b) / (b - t), 0.5f, 1.0f},
+        };
+        std::memcpy(mapped.pData, projection, sizeof(projection));
+        context->Unmap(constant_buffer, 0);
+    }
+
+    const UINT stride = sizeof(ImDrawVert);
+    const UINT offset = 0;
+    context->IASetInputLayout(input_layout);
+    context->IASetVertexBuffers(0, 1, &vertex_buffer, &stride, &offset);
+    context->IASetIndexBuffer(index_buffer, sizeof(ImDrawIdx) == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->VSSetShader(vertex_shader, nullptr, 0);
+    context->VSSetConstantBuffers(0, 1, &constant_buffer);
+    context->PSSetShader(pixel_shader, nullptr, 0);
+    context->PSSetSamplers(0, 1, &sampler);
+    context->GSSetShader(nullptr, nullptr, 0);
+    context->HSSetShader(nullptr, nullptr, 0);
+    context->DSSetShader(nullptr, nullptr, 0);
+    context->CSSetShader(nullptr, nullptr, 0);
+
+    const float blend_factor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    context->OMSetBlendState(blend_state, blend_factor, 0xFFFFFFFF);
+    context->OMSetDepthStencilState(depth_stencil_state, 0);
+    context->RSSetState(rasterizer_state);
+}
+
+void DX11Backend::Draw(const ImDrawData* draw_data)
+{
+    SavedState saved{context};
+    SetupRenderState(draw_data);
+
+    // one buffer for all lists, so their offsets into it add up
+    int          vtx_offset = 0;
+    int          idx_offset = 0;
+    const ImVec2 clip_off   = draw_data->DisplayPos;
+    for (const ImDrawList* cmd_list : draw_data->CmdLists) {
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            if (cmd.UserCallback) {
+                if (cmd.UserCallback == ImDrawCallback_ResetRenderState)
+                    SetupRenderState(draw_data);
+                else
+                    cmd.UserCallback(cmd_list, &cmd);
+                continue;
+            }
+
+            const ImVec2 clip_min(cmd.ClipRect.x - clip_off.x, cmd.ClipRect.y - clip_off.y);
+            const ImVec2 clip_max(cmd.ClipRect.z - clip_off.x, cmd.ClipRect.w - clip_off.y);
+            if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
+                continue;
+
+            const D3D11_RECT scissor = {(LONG)clip_min.x, (LONG)clip_min.y, (LONG)clip_max.x, (LONG)clip_max.y};
+            context->RSSetScissorRects(1, &scissor);
+
+            auto texture = (ID3D11ShaderResourceView*)cmd.GetTexID();
+            context->PSSetShaderResources(0, 1, &texture);
+            context->DrawIndexed(cmd.ElemCount, cmd.IdxOffset + idx_offset, cmd.VtxOffset + vtx_offset);
+        }
+        vtx_offset += cmd_list->VtxBuffer.Size;
+        idx_offset += cmd_list->IdxBuffer.Size;
+    }
+
+    saved.Restore(context);
+}
+
+void DX11Backend::ReCreateFontsTexture()
+{
+    uploaded_hash = 0;
+
+    auto& io = ImGui::GetIO();
+    Release(font_view);
+    io.Fonts->SetTexID(0);
+
+    unsigned char* pixels;
+    int            width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    D3D11_TEXTURE2D_DESC desc{};
+    desc.Width            = width;
+    desc.Height           = height;
+    desc.MipLevels        = 1;
+    desc.ArraySize        = 1;
+    desc.Format           = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage            = D3D11_USAGE_DEFAULT;
+    desc.BindFlags        = D3D11_BIND_SHADER_RESOURCE;
+
+    D3D11_SUBRESOURCE_DATA data{};
+    data.pSysMem     = pixels;
+    data.SysMemPitch = desc.Width * 4;
+
+    ID3D11Texture2D* texture = nullptr;
+    if (FAILED(device->CreateTexture2D(&desc, &data, &texture))) {
+        logger::error("Failed to create the font texture ({}x{}).", width, height);
+        return;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC view_desc{};
+    view_desc.Format              = DXGI_FORMAT_R8G8B8A8_UNORM;
+    view_desc.ViewDimension       = D3D11_SRV_DIMENSION_TEXTURE2D;
+    view_desc.Texture2D.MipLevels = desc.MipLevels;
+    device->CreateShaderResourceView(texture, &view_desc, &font_view);
+    Release(texture); // held by the view
+
+    io.Fonts->SetTexID((ImTextureID)font_view);
+}
+
+// A new buffer holds nothing, so what was uploaded is gone too.
+bool DX11Backend::ResizeVertexBuffer(int capacity)
+{
+    uploaded_hash = 0;
+    return CreateBuffer(vertex_buffer, capacity, sizeof(ImDrawVert), D3D11_BIND_VERTEX_BUFFER);
+}
+
+bool DX11Backend::ResizeIndexBuffer(int capacity)
+{
+    uploaded_hash = 0;
+    return CreateBuffer(index_buffer, capacity, sizeof(ImDrawIdx), D3D11_BIND_INDEX_BUFFER);
+}
+
+bool DX11Backend::CreateBuffer(ID3D11Buffer*& buffer, int capacity, UINT element_size, UINT bind_flags)
+{
+    Release(buffer);
+
+    D3D11_BUFFER_DESC desc{};
+    desc.Usage          = D3D11_USAGE_DYNAMIC;
+    desc.ByteWidth      = capacity * element_size;
+    desc.BindFlags      = bind_flags;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    if (FAILED(device->CreateBuffer(&desc, nullptr, &buffer))) {
+        logger::warn("Failed to create a {} byte {} buffer.", desc.ByteWidth, bind_flags == D3D11_BIND_VERTEX_BUFFER ? "vertex" : "index");
+        return false;
+    }
+    return true;
+}
+
+} // namespace CatMenu
@@ -0,0 +1,55 @@
+#include "backend.h"
+
+namespace CatMenu
+{
+
+constexpr float g_delta_time = 1.0f / 144.0f;
+
+NullBackend::NullBackend(ImVec2 display_size) :
+    display_size(display_size)
+{
+}
+
+void NullBackend::Init()
+{
+    auto& io               = ImGui::GetIO();
+    io.BackendPlatformName = "catmenu_null_platform";
+    io.BackendRendererName = "catmenu_null_renderer";
+    io.IniFilename         = nullptr;
+    io.LogFilename         = nullptr;
+}
+
+void NullBackend::NewFrame()
+{
+    auto& io       = ImGui::GetIO();
+    io.DisplaySize = display_size;
+    io.DeltaTime   = g_delta_time;
+
+    if (!io.Fonts->IsBuilt() || !io.Fonts->TexID)
+        ReCreateFontsTexture();
+}
+
+bool NullBackend::RenderDrawData(ImDrawData* draw_data, uint64_t hash)
+{
+    const bool retained = hash && hash == uploaded_hash;
+    uploaded_hash       = hash;
+    if (!retained)
+        buffer_sizer.Reserve(draw_data->TotalVtxCount, draw_data->TotalIdxCount);
+
+    volatile size_t sink = 0;
+    for (const ImDrawList* cmd_list : draw_data->CmdLists)
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+            sink = sink + cmd.ElemCount;
+    return retained;
+}
+
+void NullBackend::ReCreateFontsTexture()
+{
+    auto&          io = ImGui::GetIO();
+    unsigned char* pixels;
+    int            width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    io.Fonts->SetTexID((ImTextureID)(intptr_t)&font_texture);
+}
+
+} // namespace CatMenu
@@ -0,0 +1,223 @@
+#include "backend.h"
+
+#include "worker_pool.h"
+
+namespace CatMenu
+{
+
+constexpr float g_delta_time = 1.0f / 144.0f;
+
+SoftwareBackend::SoftwareBackend(ImVec2 display_size, unsigned threads) :
+    width((int)display_size.x), height((int)display_size.y), framebuffer((size_t)width * height)
+{
+    helper_count = std::min(std::max(threads, 1u), (unsigned)((height + BandHeight - 1) / BandHeight)) - 1;
+    if (helper_count)
+        workers = std::make_unique<WorkerPool>(helper_count);
+}
+
+SoftwareBackend::~SoftwareBackend() = default;
+
+void SoftwareBackend::Init()
+{
+    auto& io               = ImGui::GetIO();
+    io.BackendPlatformName = "catmenu_null_platform";
+    io.BackendRendererName = "catmenu_software_renderer";
+    io.IniFilename         = nullptr;
+    io.LogFilename         = nullptr;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+}
+
+void SoftwareBackend::NewFrame()
+{
+    auto& io       = ImGui::GetIO();
+    io.DisplaySize = {(float)width, (float)height};
+    io.DeltaTime   = g_delta_time;
+
+    if (!io.Fonts->IsBuilt() || !io.Fonts->TexID)
+        ReCreateFontsTexture();
+}
+
+bool SoftwareBackend::RenderDrawData(ImDrawData* draw_data, uint64_t hash)
+{
+    // the framebuffer still holds the frame
+    if (hash && hash == drawn_hash)
+        return true;
+    drawn_hash = hash;
+
+    offset = draw_data->DisplayPos;
+    triangles.clear();
+    for (const ImDrawList* cmd_list : draw_data->CmdLists)
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            if (cmd.UserCallback)
+                continue; // no render state to reset, and user callbacks expect the game's renderer
+
+            // truncated like imgui_impl_dx11's scissor rects
+            const int sx0 = std::max((int)(cmd.ClipRect.x - offset.x), 0);
+            const int sy0 = std::max((int)(cmd.ClipRect.y - offset.y), 0);
+            const int sx1 = std::min((int)(cmd.ClipRect.z - offset.x), width);
+            const int sy1 = std::min((int)(cmd.ClipRect.w - offset.y), height);
+            if (sx1 <= sx0 || sy1 <= sy0)
+                continue;
+
+            const Texture*    texture = cmd.TextureId == (ImTextureID)&font ? &font : nullptr;
+            const ImDrawIdx*  idx     = cmd_list->IdxBuffer.Data + cmd.IdxOffset;
+            const ImDrawVert* vtx     = cmd_list->VtxBuffer.Data + cmd.VtxOffset;
+            for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3) {
+                const ImDrawVert* verts[3] = {&vtx[idx[i]], &vtx[idx[i + 1]], &vtx[idx[i + 2]]};
+
+                // pixel centres within the bounds and the scissor rect
+                const float min_x = std::min({verts[0]->pos.x, verts[1]->pos.x, verts[2]->pos.x}) - offset.x;
+                const float min_y = std::min({verts[0]->pos.y, verts[1]->pos.y, verts[2]->pos.y}) - offset.y;
+                const float max_x = std::max({verts[0]->pos.x, verts[1]->pos.x, verts[2]->pos.x}) - offset.x;
+                const float max_y = std::max({verts[0]->pos.y, verts[1]->pos.y, verts[2]->pos.y}) - offset.y;
+
+                Triangle triangle = {{verts[0], verts[1], verts[2]}, texture};
+                triangle.x0       = std::max(sx0, (int)std::ceil(min_x - 0.5f));
+                triangle.y0       = std::max(sy0, (int)std::ceil(min_y - 0.5f));
+                triangle.x1       = std::min(sx1, (int)std::floor(max_x - 0.5f) + 1);
+                triangle.y1       = std::min(sy1, (int)std::floor(max_y - 0.5f) + 1);
+                if (triangle.x0 < triangle.x1 && triangle.y0 < triangle.y1)
+                    triangles.push_back(triangle);
+            }
+        }
+
+    next_band.store(0, std::memory_order_relaxed);
+    helpers.store((int)helper_count, std::memory_order_relaxed);
+    for (unsigned i = 0; i < helper_count; ++i)
+        workers->Submit(RasterizeTask, this);
+
+    RasterizeBands();
+
+    // helpers that start late find no band left, but still touch this frame's state
+    for (int running; (running = helpers.load(std::memory_order_acquire)) != 0;)
+        helpers.wait(running, std::memory_order_acquire);
+    return false;
+}
+
+void SoftwareBackend::ReCreateFontsTexture()
+{
+    auto&          io = ImGui::GetIO();
+    unsigned char* pixels;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &font.width, &font.height);
+    font.pixels.resize((size_t)font.width * font.height);
+    std::memcpy(font.pixels.data(), pixels, font.pixels.size() * sizeof(uint32_t));
+    io.Fonts->SetTexID((ImTextureID)&font);
+
+    drawn_hash = 0;
+}
+
+void SoftwareBackend::RasterizeTask(void* backend)
+{
+    auto self = static_cast<SoftwareBackend*>(backend);
+    self->RasterizeBands();
+    if (self->helpers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        self->helpers.notify_all();
+}
+
+void SoftwareBackend::RasterizeBands()
+{
+    const int bands = (height + BandHeight - 1) / BandHeight;
+    for (int band; (band = next_band.fetch_add(1, std::memory_order_relaxed)) < bands;) {
+        const int y0 = band * BandHeight;
+        const int y1 = std::min(y0 + BandHeight, height);
+        std::fill(framebuffer.data() + (size_t)y0 * width, framebuffer.data() + (size_t)y1 * width, 0u);
+        for (const Triangle& triangle : triangles)
+            if (triangle.y0 < y1 && triangle.y1 > y0)
+                DrawTriangle(triangle, y0, y1);
+    }
+}
+
+// Edge function of a->b: positive on the inside of a triangle with positive area. Evaluated
+// from a canonical endpoint order, so the two triangles sharing an edge get exactly opposite
+// values and a pixel centre on it is owned by exactly one of them.
+struct EdgeFunction
+{
+    ImVec2 origin;
+    ImVec2 delta;
+    float  sign;
+    bool   owns_ties; // pixel centres exactly on the edge are inside
+
+    EdgeFunction(ImVec2 a, ImVec2 b)
+    {
+        const bool swap = b.y < a.y || (b.y == a.y && b.x < a.x);
+        origin          = swap ? b : a;
+        delta           = swap ? ImVec2{a.x - b.x, a.y - b.y} : ImVec2{b.x - a.x, b.y - a.y};
+        sign            = swap ? -1.0f : 1.0f;
+        owns_ties       = !swap;
+    }
+
+    float At(float x, float y) const { return sign * (delta.x * (y - origin.y) - delta.y * (x - origin.x)); }
+    bool  Inside(float value) const { return value > 0.0f || (value == 0.0f && owns_ties); }
+};
+
+static ImVec4 UnpackColor(uint32_t color)
+{
+    return {(float)(color & 0xFF), (float)(color >> 8 & 0xFF), (float)(color >> 16 & 0xFF), (float)(color >> 24)};
+}
+
+void SoftwareBackend::DrawTriangle(const Triangle& triangle, int band_y0, int band_y1)
+{
+    const ImDrawVert* verts[3] = {triangle.verts[0], triangle.verts[1], triangle.verts[2]};
+    ImVec2            pos[3];
+    for (int i = 0; i < 3; ++i)
+        pos[i] = {verts[i]->pos.x - offset.x, verts[i]->pos.y - offset.y};
+
+    float area = (pos[1].x - pos[0].x) * (pos[2].y - pos[0].y) - (pos[1].y - pos[0].y) * (pos[2].x - pos[0].x);
+    if (area == 0.0f)
+        return;
+    if (area < 0.0f) { // no culling: wind every triangle the same way
+        std::swap(verts[1], verts[2]);
+        std::swap(pos[1], pos[2]);
+        area = -area;
+    }
+
+    // weight of vertex i is the edge opposite it
+    const EdgeFunction edges[3]  = {{pos[1], pos[2]}, {pos[2], pos[0]}, {pos[0], pos[1]}};
+    const ImVec4       colors[3] = {UnpackColor(verts[0]->col), UnpackColor(verts[1]->col), UnpackColor(verts[2]->col)};
+    const bool         flat      = verts[0]->col == verts[1]->col && verts[1]->col == verts[2]->col;
+    const float        inv_area  = 1.0f / area;
+    const Texture*     texture   = triangle.texture;
+
+    const int y0 = std::max(triangle.y0, band_y0);
+    const int y1 = std::min(triangle.y1, band_y1);
+    for (int y = y0; y < y1; ++y) {
+        uint32_t*   row = framebuffer.data() + (size_t)y * width;
+        const float py  = (float)y + 0.5f;
+        for (int x = triangle.x0; x < triangle.x1; ++x) {
+            const float px = (float)x + 0.5f;
+            const float w0 = edges[0].At(px, py);
+            const float w1 = edges[1].At(px, py);
+            const float w2 = edges[2].At(px, py);
+            if (!edges[0].Inside(w0) || !edges[1].Inside(w1) || !edges[2].Inside(w2))
+                continue;
+
+            const float l0 = w0 * inv_area, l1 = w1 * inv_area, l2 = w2 * inv_area;
+
+            ImVec4 color = colors[0];
+            if (!flat)
+                color = {colors[0].x * l0 + colors[1].x * l1 + colors[2].x * l2,
+                         colors[0].y * l0 + colors[1].y * l1 + colors[2].y * l2,
+                         colors[0].z * l0 + colors[1].z * l1 + colors[2].z * l2,
+                         colors[0].w * l0 + colors[1].w * l1 + colors[2].w * l2};
+
+            if (texture) {
+                const float u  = verts[0]->uv.x * l0 + verts[1]->uv.x * l1 + verts[2]->uv.x * l2;
+                const float v  = verts[0]->uv.y * l0 + verts[1]->uv.y * l1 + verts[2]->uv.y * l2;
+                const int   tx = std::clamp((int)(u * (float)texture->width), 0, texture->width - 1);
+                const int   ty = std::clamp((int)(v * (float)texture->height), 0, texture->height - 1);
+                const auto  t  = UnpackColor(texture->pixels[(size_t)ty * texture->width + tx]);
+                color          = {color.x * t.x / 255.0f, color.y * t.y / 255.0f, color.z * t.z / 255.0f, color.w * t.w / 255.0f};
+            }
+
+            // colour: SRC_ALPHA, INV_SRC_ALPHA; alpha: ONE, INV_SRC_ALPHA
+            const float  alpha = color.w / 255.0f;
+            const ImVec4 dst   = UnpackColor(row[x]);
+            const auto   blend = [&](float src, float dst_channel, float src_factor) {
+                return (uint32_t)std::clamp(src * src_factor + dst_channel * (1.0f - alpha) + 0.5f, 0.0f, 255.0f);
+            };
+            row[x] = blend(color.x, dst.x, alpha) | blend(color.y, dst.y, alpha) << 8 | blend(color.z, dst.z, alpha) << 16 | blend(color.w, dst.w, 1.0f) << 24;
+        }
+    }
+}
+
+} // namespace CatMenu
@@ -0,0 +1,79 @@
+#include "buffer_sizer.h"
+
+namespace CatMenu
+{
+
+constexpr int g_granularity = 1024; // elements; keeps capacities from creeping up by a few at a time
+
+BufferSizer::BufferSizer(BufferDevice& device) :
+    BufferSizer(device, Config{})
+{
+}
+
+BufferSizer::BufferSizer(BufferDevice& device, Config config) :
+    device(device), config(config)
+{
+    vertices.min = std::max(config.min_vertices, 1);
+    indices.min  = std::max(config.min_indices, 1);
+    vertices.capacity.store(Fit(vertices, 0), std::memory_order_relaxed);
+    indices.capacity.store(Fit(indices, 0), std::memory_order_relaxed);
+}
+
+int BufferSizer::Fit(const Buffer& buffer, int needed) const
+{
+    const int wanted = (int)std::ceil((double)needed * (1.0 + config.headroom) / g_granularity) * g_granularity;
+    return std::max({buffer.min, needed, wanted});
+}
+
+void BufferSizer::Presize(int vertex_peak, int index_peak)
+{
+    vertices.capacity.store(std::max(GetVertexCapacity(), Fit(vertices, vertex_peak)), std::memory_order_relaxed);
+    indices.capacity.store(std::max(GetIndexCapacity(), Fit(indices, index_peak)), std::memory_order_relaxed);
+    vertices.stale = indices.stale = true;
+}
+
+bool BufferSizer::Update(Buffer& buffer, int needed)
+{
+    if (needed > buffer.peak.load(std::memory_order_relaxed))
+        buffer.peak.store(needed, std::memory_order_relaxed);
+
+    const int capacity = buffer.capacity.load(std::memory_order_relaxed);
+    if (needed > capacity) {
+        buffer.capacity.store(Fit(buffer, needed), std::memory_order_relaxed);
+        buffer.window_peak  = needed;
+        buffer.quiet_frames = 0;
+        return true;
+    }
+
+    // shrink only once frames have needed under half of it for long, and only to what they needed
+    // with headroom, so a size that comes and goes does not resize on every swing
+    if (needed * 2 >= capacity) {
+        buffer.window_peak  = 0;
+        buffer.quiet_frames = 0;
+    } else {
+        buffer.window_peak = std::max(buffer.window_peak, needed);
+        const int fit      = Fit(buffer, buffer.window_peak);
+        if (fit < capacity && ++buffer.quiet_frames >= config.shrink_after) {
+            buffer.capacity.store(fit, std::memory_order_relaxed);
+            buffer.window_peak  = 0;
+            buffer.quiet_frames = 0;
+            return true;
+        }
+    }
+
+    return buffer.stale;
+}
+
+void BufferSizer::Reserve(int vertex_count, int index_count)
+{
+    if (Update(vertices, vertex_count) && device.ResizeVertexBuffer(GetVertexCapacity())) {
+        vertices.stale = false;
+        resizes.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (Update(indices, index_count) && device.ResizeIndexBuffer(GetIndexCapacity())) {
+        indices.stale = false;
+        resizes.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace CatMenu
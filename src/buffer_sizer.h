@@ -0,0 +1,72 @@
+#pragma once
+
+namespace CatMenu
+{
+
+// Where BufferSizer's decisions are carried out: the renderer that owns the dynamic vertex and
+// index buffers, and creates them itself.
+class BufferDevice
+{
+public:
+    virtual ~BufferDevice() = default;
+
+    // Replaces the buffer with one of capacity elements; what it held is lost. False if it could
+    // not be created, which the next Reserve tries again.
+    virtual bool ResizeVertexBuffer(int capacity) = 0;
+    virtual bool ResizeIndexBuffer(int capacity) = 0;
+};
+
+// Capacity policy for a renderer's vertex and index buffers. imgui_impl_dx11 grows them to just
+// past the frame that overflowed and never shrinks, so a table that keeps growing recreates them
+// again and again, each time stalling the frame. Here a buffer that overflows grows with headroom
+// past the new high-water mark, starts at the previous session's peak, and only shrinks after
+// a long stretch of frames needing well under half of it.
+// Used by the render thread; the getters can be read from any thread.
+class BufferSizer
+{
+public:
+    struct Config
+    {
+        int   min_vertices = 5000;  // imgui_impl_dx11's initial sizes
+        int   min_indices  = 10000;
+        float headroom     = 0.5f;  // grown to the need times 1 + headroom
+        int   shrink_after = 3600;  // frames under half the capacity before shrinking, a minute at 60 FPS
+    };
+
+    explicit BufferSizer(BufferDevice& device);
+    BufferSizer(BufferDevice& device, Config config);
+
+    // Before the first frame: start big enough for a peak seen before, 0 for none.
+    void Presize(int vertex_peak, int index_peak);
+
+    // Before a frame's upload. Resizes what does not fit or has been far too big for long.
+    void Reserve(int vertex_count, int index_count);
+
+    int      GetVertexCapacity() const { return vertices.capacity.load(std::memory_order_relaxed); }
+    int      GetIndexCapacity() const { return indices.capacity.load(std::memory_order_relaxed); }
+    int      GetPeakVertices() const { return vertices.peak.load(std::memory_order_relaxed); } // this session
+    int      GetPeakIndices() const { return indices.peak.load(std::memory_order_relaxed); }
+    uint64_t GetResizeCount() const { return resizes.load(std::memory_order_relaxed); } // initial creation included, failures not
+
+private:
+    struct Buffer
+    {
+        int              min;
+        std::atomic<int> capacity     = 0;
+        std::atomic<int> peak         = 0;
+        int              window_peak  = 0;    // largest need since the buffer was last busy
+        int              quiet_frames = 0;    // in a row under half the capacity
+        bool             stale        = true; // the device holds no buffer of capacity yet
+    };
+
+    int  Fit(const Buffer& buffer, int needed) const; // capacity for needed, with headroom
+    bool Update(Buffer& buffer, int needed);           // whether the buffer needs resizing
+
+    BufferDevice&         device;
+    Config                config;
+    Buffer                vertices;
+    Buffer                indices;
+    std::atomic<uint64_t> resizes = 0;
+};
+
+} // namespace CatMenu
@@ -0,0 +1,68 @@
+#include "context_memory.h"
+
+#include <imgui_internal.h>
+
+namespace CatMenu
+{
+
+template <typename T>
+static size_t Capacity(const ImVector<T>& vector)
+{
+    return (size_t)vector.Capacity * sizeof(T);
+}
+
+static size_t GetSplitterMemory(const ImDrawListSplitter& splitter)
+{
+    size_t bytes = Capacity(splitter._Channels);
+    for (const ImDrawChannel& channel : splitter._Channels)
+        bytes += Capacity(channel._CmdBuffer) + Capacity(channel._IdxBuffer);
+    return bytes;
+}
+
+size_t GetContextMemory(const ImGuiContext* context)
+{
+    if (!context)
+        return 0;
+
+    size_t bytes = 0;
+    for (const ImGuiWindow* window : context->Windows) {
+        const ImDrawList& list = window->DrawListInst;
+        bytes += sizeof(ImGuiWindow);
+        bytes += Capacity(list.CmdBuffer) + Capacity(list.IdxBuffer) + Capacity(list.VtxBuffer) + Capacity(list._Path);
+        bytes += GetSplitterMemory(list._Splitter);
+        bytes += Capacity(window->IDStack) + Capacity(window->StateStorage.Data) + Capacity(window->ColumnsStorage);
+        bytes += Capacity(window->DC.ChildWindows) + Capacity(window->DC.ItemWidthStack) + Capacity(window->DC.TextWrapPosStack);
+    }
+    for (const ImGuiTableTempData& temp_data : context->TablesTempData)
+        bytes += sizeof(ImGuiTableTempData) + GetSplitterMemory(temp_data.DrawSplitter);
+    return bytes;
+}
+
+void CompactContext(ImGuiContext* context, bool all)
+{
+    if (!context)
+        return;
+
+    // the Gc functions work on the current context
+    auto prev = ImGui::GetCurrentContext();
+    ImGui::SetCurrentContext(context);
+
+    // Active still describes the last frame until the next NewFrame
+    auto& g = *context;
+    for (ImGuiWindow* window : g.Windows)
+        if ((all || !window->Active) && !window->MemoryCompacted)
+            ImGui::GcCompactTransientWindowBuffers(window);
+
+    for (int i = 0; i < g.Tables.GetMapSize(); i++)
+        if (ImGuiTable* table = g.Tables.TryGetMapData(i))
+            if (!table->MemoryCompacted && (all || table->LastFrameActive < g.FrameCount))
+                ImGui::TableGcCompactTransientBuffers(table);
+    for (ImGuiTableTempData& temp_data : g.TablesTempData)
+        if (temp_data.LastTimeActive >= 0.0f && (all || temp_data.LastTimeActive < (float)g.Time))
+            ImGui::TableGcCompactTransientBuffers(&temp_data);
+    ImGui::TableGcCompactSettings();
+
+    ImGui::SetCurrentContext(prev);
+}
+
+} // namespace CatMenu
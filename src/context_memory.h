@@ -0,0 +1,21 @@
+#pragma once
+
+#include "imgui.h"
+
+struct ImGuiContext;
+
+namespace CatMenu
+{
+
+// Heap held by a context's windows and tables, in bytes. An estimate: counts the buffers that
+// grow with use (draw lists, ID stacks, state storage, table scratch data), not fixed-size
+// allocations or the font atlas.
+size_t GetContextMemory(const ImGuiContext* context);
+
+// Releases the buffers of windows and tables that were not used on the last frame, like ImGui
+// does on its own after io.ConfigMemoryCompactTimer. They are reallocated when the window is
+// shown again. Call between frames, from the thread that builds the context. With all, those of
+// the last frame go too; its draw data must then not be submitted again.
+void CompactContext(ImGuiContext* context, bool all = false);
+
+} // namespace CatMenu
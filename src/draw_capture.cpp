@@ -0,0 +1,209 @@
+#include "draw_capture.h"
+
+#include <ImGuiNotify.hpp>
+
+namespace CatMenu
+{
+
+// On disk, little-endian as written: Header, then per frame a FrameHeader followed by
+// list_count times (ListHeader, Cmd[cmd_count], ImDrawVert[vtx_count], ImDrawIdx[idx_count]).
+
+struct Header
+{
+    char     magic[4]    = {'C', 'M', 'D', 'C'};
+    uint32_t version     = 1;
+    uint32_t vertex_size = sizeof(ImDrawVert);
+    uint32_t index_size  = sizeof(ImDrawIdx);
+};
+
+struct FrameHeader
+{
+    ImVec2   display_pos;
+    ImVec2   display_size;
+    ImVec2   framebuffer_scale;
+    uint32_t list_count;
+};
+
+struct ListHeader
+{
+    uint32_t cmd_count;
+    uint32_t vtx_count;
+    uint32_t idx_count;
+    uint32_t flags;
+};
+
+struct Cmd
+{
+    ImVec4   clip_rect;
+    uint64_t texture_id;
+    uint32_t vtx_offset;
+    uint32_t idx_offset;
+    uint32_t elem_count;
+    uint32_t reset_render_state; // an ImDrawCallback_ResetRenderState command
+};
+
+template <typename T>
+static void WriteValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool ReadValue(std::ifstream& file, T& value)
+{
+    return (bool)file.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+static bool IsCaptured(const ImDrawCmd& cmd)
+{
+    return !cmd.UserCallback || cmd.UserCallback == ImDrawCallback_ResetRenderState;
+}
+
+bool DrawCaptureWriter::Open(const std::filesystem::path& path)
+{
+    Close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    this->path = path;
+    WriteValue(file, Header{});
+    return true;
+}
+
+void DrawCaptureWriter::Write(const ImDrawData* draw_data)
+{
+    WriteValue(file, FrameHeader{draw_data->DisplayPos, draw_data->DisplaySize, draw_data->FramebufferScale, (uint32_t)draw_data->CmdListsCount});
+
+    for (const ImDrawList* list : draw_data->CmdLists) {
+        const auto cmd_count = std::ranges::count_if(list->CmdBuffer, IsCaptured);
+        WriteValue(file, ListHeader{(uint32_t)cmd_count, (uint32_t)list->VtxBuffer.Size, (uint32_t)list->IdxBuffer.Size, (uint32_t)list->Flags});
+
+        for (const ImDrawCmd& cmd : list->CmdBuffer)
+            if (IsCaptured(cmd))
+                WriteValue(file, Cmd{cmd.ClipRect, (uint64_t)(uintptr_t)cmd.TextureId, cmd.VtxOffset, cmd.IdxOffset, cmd.ElemCount, cmd.UserCallback != nullptr});
+
+        file.write(reinterpret_cast<const char*>(list->VtxBuffer.Data), list->VtxBuffer.size_in_bytes());
+        file.write(reinterpret_cast<const char*>(list->IdxBuffer.Data), list->IdxBuffer.size_in_bytes());
+    }
+}
+
+void DrawCaptureWriter::Close()
+{
+    if (file.is_open())
+        file.close();
+}
+
+DrawCapture::Frame::~Frame()
+{
+    for (auto list : lists)
+        IM_DELETE(list);
+}
+
+void DrawCaptureRecorder::Request(int frames, std::filesystem::path path)
+{
+    std::lock_guard lock(mutex);
+    this->frames = frames;
+    this->path   = std::move(path);
+    requested.store(true, std::memory_order_release);
+}
+
+void DrawCaptureRecorder::Record(const ImDrawData* draw_data)
+{
+    if (requested.exchange(false, std::memory_order_acquire)) {
+        std::lock_guard lock(mutex);
+
+        if (writer.Open(path)) {
+            left = std::max(frames, 1);
+            logger::info("Capturing {} frames of draw data to {}.", left, path.string());
+        } else {
+            logger::warn("Failed to create draw capture {}.", path.string());
+            ImGui::InsertNotification({ImGuiToastType::Warning, 5000, "Failed to create draw capture %s.", path.string().c_str()});
+        }
+    }
+
+    if (!left || !draw_data)
+        return;
+
+    writer.Write(draw_data);
+    if (--left == 0) {
+        writer.Close();
+        logger::info("Draw capture written to {}.", writer.GetPath().string());
+        ImGui::InsertNotification({ImGuiToastType::Success, 5000, "Draw capture written to %s.", writer.GetPath().string().c_str()});
+    }
+}
+
+bool DrawCapture::Frame::Read(std::ifstream& file, uint32_t list_count)
+{
+    for (uint32_t i = 0; i < list_count; ++i) {
+        ListHeader list_header;
+        if (!ReadValue(file, list_header))
+            return false;
+
+        auto list   = lists.emplace_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+        list->Flags = (ImDrawListFlags)list_header.flags;
+
+        list->CmdBuffer.resize((int)list_header.cmd_count);
+        for (ImDrawCmd& cmd : list->CmdBuffer) {
+            Cmd captured;
+            if (!ReadValue(file, captured))
+                return false;
+            cmd              = ImDrawCmd{};
+            cmd.ClipRect     = captured.clip_rect;
+            cmd.TextureId    = (ImTextureID)(uintptr_t)captured.texture_id;
+            cmd.VtxOffset    = captured.vtx_offset;
+            cmd.IdxOffset    = captured.idx_offset;
+            cmd.ElemCount    = captured.elem_count;
+            cmd.UserCallback = captured.reset_render_state ? ImDrawCallback_ResetRenderState : nullptr;
+        }
+
+        list->VtxBuffer.resize((int)list_header.vtx_count);
+        list->IdxBuffer.resize((int)list_header.idx_count);
+        if (!file.read(reinterpret_cast<char*>(list->VtxBuffer.Data), list->VtxBuffer.size_in_bytes()) ||
+            !file.read(reinterpret_cast<char*>(list->IdxBuffer.Data), list->IdxBuffer.size_in_bytes()))
+            return false;
+
+        draw_data.CmdLists.push_back(list);
+        draw_data.TotalVtxCount += list->VtxBuffer.Size;
+        draw_data.TotalIdxCount += list->IdxBuffer.Size;
+    }
+
+    draw_data.Valid         = true;
+    draw_data.CmdListsCount = draw_data.CmdLists.Size;
+    return true;
+}
+
+bool DrawCapture::Load(const std::filesystem::path& path)
+{
+    frames.clear();
+
+    std::ifstream file(path, std::ios::binary);
+    Header        header;
+    if (!ReadValue(file, header) || std::memcmp(header.magic, Header{}.magic, sizeof(header.magic)) || header.version != Header{}.version ||
+        header.vertex_size != sizeof(ImDrawVert) || header.index_size != sizeof(ImDrawIdx))
+        return false;
+
+    FrameHeader frame_header;
+    while (ReadValue(file, frame_header)) {
+        auto frame = std::make_unique<Frame>();
+        if (!frame->Read(file, frame_header.list_count))
+            break;
+
+        frame->draw_data.DisplayPos       = frame_header.display_pos;
+        frame->draw_data.DisplaySize      = frame_header.display_size;
+        frame->draw_data.FramebufferScale = frame_header.framebuffer_scale;
+        frames.push_back(std::move(frame));
+    }
+
+    return !frames.empty();
+}
+
+void DrawCapture::RemapTextures(ImTextureID texture)
+{
+    for (const auto& frame : frames)
+        for (ImDrawList* list : frame->lists)
+            for (ImDrawCmd& cmd : list->CmdBuffer)
+                cmd.TextureId = texture;
+}
+
+} // namespace CatMenu
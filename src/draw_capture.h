@@ -0,0 +1,79 @@
+#pragma once
+
+#include "imgui.h"
+
+namespace CatMenu
+{
+
+// Binary capture of the draw data handed to the renderer, frame by frame: display rect, and
+// per draw list its commands (clip rect, texture ID, offsets), vertices and indices, raw.
+// Replayed offline with catmenu_bench --replay to time renderer changes on real frames.
+// Texture IDs mean nothing outside the session that recorded them, so a replay maps them to
+// textures of its own. Draw callbacks other than ImDrawCallback_ResetRenderState are dropped.
+class DrawCaptureWriter
+{
+public:
+    bool Open(const std::filesystem::path& path); // writes the header, false if the file cannot be created
+    void Write(const ImDrawData* draw_data);
+    void Close();
+
+    bool                         IsOpen() const { return file.is_open(); }
+    const std::filesystem::path& GetPath() const { return path; }
+
+private:
+    std::ofstream         file;
+    std::filesystem::path path;
+};
+
+// Writes the next frames handed to the renderer with a DrawCaptureWriter. Requested from any
+// thread, recorded by the render thread as it submits frames.
+class DrawCaptureRecorder
+{
+public:
+    void Request(int frames, std::filesystem::path path);
+
+    // After each submit, nullptr if there was nothing to submit. Frames with nothing to draw are
+    // not captured, so the count is of frames that are.
+    void Record(const ImDrawData* draw_data);
+
+private:
+    std::atomic<bool>     requested = false;
+    std::mutex            mutex;
+    std::filesystem::path path;       // guarded
+    int                   frames = 0; // guarded
+    DrawCaptureWriter     writer;     // render thread
+    int                   left = 0;   // render thread
+};
+
+class DrawCapture
+{
+public:
+    // Needs a current ImGui context for the draw lists. False if the file is missing, holds no
+    // complete frame or was written with another vertex or index layout. A frame cut short, as
+    // by a crash while capturing, is dropped.
+    bool Load(const std::filesystem::path& path);
+
+    int         GetFrameCount() const { return (int)frames.size(); }
+    ImDrawData* GetFrame(int index) { return &frames[index]->draw_data; }
+
+    // Points every command at texture, e.g. the replaying backend's font atlas.
+    void RemapTextures(ImTextureID texture);
+
+private:
+    struct Frame
+    {
+        ImDrawData               draw_data;
+        std::vector<ImDrawList*> lists; // owned
+
+        Frame() = default;
+        ~Frame();
+
+        Frame(const Frame&)            = delete;
+        Frame& operator=(const Frame&) = delete;
+
+        bool Read(std::ifstream& file, uint32_t list_count);
+    };
+    std::vector<std::unique_ptr<Frame>> frames;
+};
+
+} // namespace CatMenu
@@ -0,0 +1,193 @@
+#include "draw_data.h"
+
+namespace CatMenu
+{
+
+template <typename T>
+static void CopyVector(ImVector<T>& dst, const ImVector<T>& src)
+{
+    dst.resize(src.Size); // unlike operator=, keeps the existing allocation
+    if (src.Size)
+        std::memcpy(dst.Data, src.Data, src.size_in_bytes());
+}
+
+void CopyDrawList(ImDrawList* dst, const ImDrawList* src)
+{
+    CopyVector(dst->CmdBuffer, src->CmdBuffer);
+    CopyVector(dst->IdxBuffer, src->IdxBuffer);
+    CopyVector(dst->VtxBuffer, src->VtxBuffer);
+    dst->Flags = src->Flags;
+}
+
+void InsertDrawList(ImDrawData* draw_data, int& index, ImDrawList* list)
+{
+    draw_data->CmdLists.insert(draw_data->CmdLists.Data + index++, list);
+    draw_data->CmdListsCount++;
+    draw_data->TotalVtxCount += list->VtxBuffer.Size;
+    draw_data->TotalIdxCount += list->IdxBuffer.Size;
+}
+
+DrawDataSnapshot::~DrawDataSnapshot()
+{
+    for (auto list : lists)
+        IM_DELETE(list);
+}
+
+void DrawDataSnapshot::Capture(const ImDrawData* src)
+{
+    while ((int)lists.size() < src->CmdListsCount)
+        lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+
+    draw_data.CmdLists.resize(src->CmdListsCount);
+    for (int i = 0; i < src->CmdListsCount; ++i) {
+        CopyDrawList(lists[i], src->CmdLists[i]);
+        draw_data.CmdLists[i] = lists[i];
+    }
+
+    draw_data.Valid            = true;
+    draw_data.CmdListsCount    = src->CmdListsCount;
+    draw_data.TotalIdxCount    = src->TotalIdxCount;
+    draw_data.TotalVtxCount    = src->TotalVtxCount;
+    draw_data.DisplayPos       = src->DisplayPos;
+    draw_data.DisplaySize      = src->DisplaySize;
+    draw_data.FramebufferScale = src->FramebufferScale;
+    draw_data.OwnerViewport    = src->OwnerViewport;
+}
+
+DrawCmdMerger::~DrawCmdMerger()
+{
+    for (auto list : lists)
+        IM_DELETE(list);
+}
+
+static bool IsMergeable(const ImDrawList* list)
+{
+    for (const ImDrawCmd& cmd : list->CmdBuffer)
+        if (cmd.UserCallback || cmd.VtxOffset)
+            return false;
+    return true;
+}
+
+// What renderers pass as the scissor rect: framebuffer space, truncated like the backends' casts.
+static ImVec4 ScissorRect(const ImVec4& clip, ImVec2 offset)
+{
+    return {std::trunc(clip.x - offset.x), std::trunc(clip.y - offset.y), std::trunc(clip.z - offset.x), std::trunc(clip.w - offset.y)};
+}
+
+// Whether the scissor rect leaves the command's triangles whole. Pixels are covered by their
+// centres, so geometry within the truncated rect never reaches a pixel outside it.
+static bool IsUnclipped(const ImDrawCmd& cmd, const ImDrawList* list, ImVec2 offset)
+{
+    const ImVec4     scissor = ScissorRect(cmd.ClipRect, offset);
+    const ImDrawIdx* idx     = list->IdxBuffer.Data + cmd.IdxOffset;
+    for (unsigned int i = 0; i < cmd.ElemCount; ++i) {
+        const ImVec2 pos = list->VtxBuffer.Data[idx[i]].pos;
+        if (pos.x - offset.x < scissor.x || pos.y - offset.y < scissor.y || pos.x - offset.x > scissor.z || pos.y - offset.y > scissor.w)
+            return false;
+    }
+    return true;
+}
+
+ImDrawData* DrawCmdMerger::Merge(const ImDrawData* src)
+{
+    constexpr size_t max_vertices = (size_t)1 << (8 * sizeof(ImDrawIdx)); // addressable by an index
+
+    const ImVec2 offset         = src->DisplayPos;
+    ImDrawList*  out            = nullptr; // list being appended to
+    bool         last_unclipped = false;   // of out's last command
+    int          used           = 0;
+
+    draw_data.CmdLists.resize(0);
+    for (ImDrawList* list : src->CmdLists) {
+        if (!IsMergeable(list)) {
+            draw_data.CmdLists.push_back(list);
+            out = nullptr;
+            continue;
+        }
+
+        if (!out || (size_t)out->VtxBuffer.Size + list->VtxBuffer.Size > max_vertices) {
+            if (used == (int)lists.size())
+                lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+            out = lists[used++];
+            out->CmdBuffer.resize(0);
+            out->IdxBuffer.resize(0);
+            out->VtxBuffer.resize(0);
+            out->Flags = list->Flags;
+            draw_data.CmdLists.push_back(out);
+        }
+
+        const int vtx_base = out->VtxBuffer.Size;
+        const int idx_base = out->IdxBuffer.Size;
+        out->VtxBuffer.resize(vtx_base + list->VtxBuffer.Size);
+        if (list->VtxBuffer.Size)
+            std::memcpy(out->VtxBuffer.Data + vtx_base, list->VtxBuffer.Data, list->VtxBuffer.size_in_bytes());
+        out->IdxBuffer.resize(idx_base + list->IdxBuffer.Size);
+        for (int i = 0; i < list->IdxBuffer.Size; ++i)
+            out->IdxBuffer.Data[idx_base + i] = (ImDrawIdx)(list->IdxBuffer.Data[i] + vtx_base);
+
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            if (!cmd.ElemCount)
+                continue;
+
+            const bool unclipped = IsUnclipped(cmd, list, offset);
+            ImDrawCmd* last      = out->CmdBuffer.Size ? &out->CmdBuffer.back() : nullptr;
+            if (last && last->TextureId == cmd.TextureId && last->IdxOffset + last->ElemCount == idx_base + cmd.IdxOffset) {
+                const bool same_clip = std::memcmp(&last->ClipRect, &cmd.ClipRect, sizeof(ImVec4)) == 0;
+                if (same_clip || (last_unclipped && unclipped)) {
+                    last->ClipRect.x = std::min(last->ClipRect.x, cmd.ClipRect.x);
+                    last->ClipRect.y = std::min(last->ClipRect.y, cmd.ClipRect.y);
+                    last->ClipRect.z = std::max(last->ClipRect.z, cmd.ClipRect.z);
+                    last->ClipRect.w = std::max(last->ClipRect.w, cmd.ClipRect.w);
+                    last->ElemCount += cmd.ElemCount;
+                    last_unclipped = last_unclipped && unclipped;
+                    continue;
+                }
+            }
+
+            ImDrawCmd merged = cmd;
+            merged.IdxOffset = idx_base + cmd.IdxOffset;
+            out->CmdBuffer.push_back(merged);
+            last_unclipped = unclipped;
+        }
+    }
+
+    draw_data.Valid            = true;
+    draw_data.CmdListsCount    = draw_data.CmdLists.Size;
+    draw_data.TotalIdxCount    = src->TotalIdxCount;
+    draw_data.TotalVtxCount    = src->TotalVtxCount;
+    draw_data.DisplayPos       = src->DisplayPos;
+    draw_data.DisplaySize      = src->DisplaySize;
+    draw_data.FramebufferScale = src->FramebufferScale;
+    draw_data.OwnerViewport    = src->OwnerViewport;
+    return &draw_data;
+}
+
+uint32_t CountDrawCalls(const ImDrawData* draw_data)
+{
+    uint32_t calls = 0;
+    for (const ImDrawList* list : draw_data->CmdLists)
+        for (const ImDrawCmd& cmd : list->CmdBuffer)
+            calls += !cmd.UserCallback && cmd.ElemCount;
+    return calls;
+}
+
+DrawListCache::~DrawListCache()
+{
+    for (auto list : lists)
+        IM_DELETE(list);
+}
+
+void DrawListCache::Add(const ImDrawList* src)
+{
+    if (size == (int)lists.size())
+        lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+    CopyDrawList(lists[size++], src);
+}
+
+void DrawListCache::InsertInto(ImDrawData* draw_data, int& index) const
+{
+    for (int i = 0; i < size; ++i)
+        InsertDrawList(draw_data, index, lists[i]);
+}
+
+} // namespace CatMenu
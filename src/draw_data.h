@@ -0,0 +1,85 @@
+#pragma once
+
+#include "imgui.h"
+
+namespace CatMenu
+{
+
+// Copies command, index and vertex buffers. Reuses dst's capacity, so copying a frame of
+// similar size allocates nothing.
+void CopyDrawList(ImDrawList* dst, const ImDrawList* src);
+
+// Inserts list into draw_data at index, advancing index past it. draw_data does not own it.
+void InsertDrawList(ImDrawData* draw_data, int& index, ImDrawList* list);
+
+// Deep copy of a frame's draw data, so it can be submitted while the next frame is being built.
+class DrawDataSnapshot
+{
+public:
+    DrawDataSnapshot() = default;
+    ~DrawDataSnapshot();
+
+    DrawDataSnapshot(const DrawDataSnapshot&)            = delete;
+    DrawDataSnapshot& operator=(const DrawDataSnapshot&) = delete;
+
+    void Capture(const ImDrawData* src);
+    void Clear() { draw_data.Clear(); }
+
+    // nullptr if nothing was captured
+    ImDrawData* Get() { return draw_data.Valid ? &draw_data : nullptr; }
+
+private:
+    ImDrawData               draw_data;
+    std::vector<ImDrawList*> lists; // owned, kept across captures to reuse their buffers
+};
+
+// Coalesces consecutive draw commands, across draw lists, into the fewest draw calls: commands
+// merge when they use the same texture and either share a clip rect or neither is actually cut
+// by its own (the geometry fits the scissor rect a renderer would set), in which case the union
+// of both rects clips nothing either. Lists are concatenated, with rebased indices, up to what
+// the index type can address. Lists with callbacks or vertex offsets are passed through as they
+// are, since their commands depend on the list they are in.
+class DrawCmdMerger
+{
+public:
+    DrawCmdMerger() = default;
+    ~DrawCmdMerger();
+
+    DrawCmdMerger(const DrawCmdMerger&)            = delete;
+    DrawCmdMerger& operator=(const DrawCmdMerger&) = delete;
+
+    // Valid until the next Merge, and as long as src's lists: passed-through lists are src's own.
+    ImDrawData* Merge(const ImDrawData* src);
+
+private:
+    ImDrawData               draw_data;
+    std::vector<ImDrawList*> lists; // owned, kept across merges to reuse their buffers
+};
+
+// Draw calls a renderer issues for draw_data: commands with elements, callbacks aside.
+uint32_t CountDrawCalls(const ImDrawData* draw_data);
+
+// Copies of the window draw lists produced by one draw func, replayed on frames where the
+// func is not called.
+class DrawListCache
+{
+public:
+    DrawListCache() = default;
+    ~DrawListCache();
+
+    DrawListCache(const DrawListCache&)            = delete;
+    DrawListCache& operator=(const DrawListCache&) = delete;
+
+    void Clear() { size = 0; }
+    void Add(const ImDrawList* src);
+    bool Empty() const { return size == 0; }
+
+    // Inserts the cached lists into draw_data at index, advancing index past them.
+    void InsertInto(ImDrawData* draw_data, int& index) const;
+
+private:
+    std::vector<ImDrawList*> lists; // owned, kept across captures to reuse their buffers
+    int                      size = 0;
+};
+
+} // namespace CatMenu
@@ -0,0 +1,121 @@
+#include "draw_hash.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#    include <emmintrin.h>
+#    define CATMENU_HASH_SSE2
+#endif
+
+namespace CatMenu
+{
+
+// xxh3-style accumulation, 16 bytes per step: each 64-bit lane adds the swapped input and
+// the product of the input's 32-bit halves, mixed with a key. Two accumulators keep both
+// multipliers busy. The tail is zero-padded; lengths are mixed in separately.
+
+static constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+
+static uint64_t Mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= Prime2;
+    h ^= h >> 29;
+    h *= Prime1;
+    h ^= h >> 32;
+    return h;
+}
+
+#ifdef CATMENU_HASH_SSE2
+
+struct Accumulator
+{
+    __m128i acc[2] = {_mm_set_epi64x(Prime1, Prime2), _mm_set_epi64x(Prime2, Prime1)};
+
+    static __m128i Step(__m128i acc, __m128i data, __m128i key)
+    {
+        const __m128i data_key = _mm_xor_si128(data, key);
+        const __m128i product  = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+        const __m128i swapped  = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        return _mm_add_epi64(_mm_add_epi64(acc, swapped), product);
+    }
+
+    void Add(const void* bytes, size_t size)
+    {
+        static const __m128i key0 = _mm_set_epi64x(0x1CAD21F72C81017Cll, 0xBE4BA423396CFEB8ll);
+        static const __m128i key1 = _mm_set_epi64x(0xDB979083E96DD4DEll, 0x1F67B3B7A4A44072ll);
+
+        auto p = static_cast<const char*>(bytes);
+        for (; size >= 32; p += 32, size -= 32) {
+            acc[0] = Step(acc[0], _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), key0);
+            acc[1] = Step(acc[1], _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), key1);
+        }
+        if (size) {
+            alignas(16) char tail[32]{};
+            std::memcpy(tail, p, size);
+            acc[0] = Step(acc[0], _mm_load_si128(reinterpret_cast<const __m128i*>(tail)), key0);
+            acc[1] = Step(acc[1], _mm_load_si128(reinterpret_cast<const __m128i*>(tail + 16)), key1);
+        }
+    }
+
+    uint64_t Finish(uint64_t length) const
+    {
+        alignas(16) uint64_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc[0]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 2), acc[1]);
+        return Mix(Mix(lanes[0] ^ lanes[3]) + Mix(lanes[1] ^ lanes[2]) + length * Prime1);
+    }
+};
+
+#else
+
+struct Accumulator
+{
+    uint64_t acc = Prime1;
+
+    void Add(const void* bytes, size_t size)
+    {
+        auto p = static_cast<const unsigned char*>(bytes);
+        for (; size >= 8; p += 8, size -= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            acc = (acc ^ Mix(word)) * Prime1;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, p, size);
+        acc = (acc ^ Mix(tail)) * Prime2;
+    }
+
+    uint64_t Finish(uint64_t length) const { return Mix(acc + length * Prime1); }
+};
+
+#endif
+
+uint64_t HashDrawData(const ImDrawData* draw_data)
+{
+    Accumulator accumulator;
+    uint64_t    length = 0; // list sizes too, so moving data between lists changes the hash
+
+    const ImVec2 rect[3] = {draw_data->DisplayPos, draw_data->DisplaySize, draw_data->FramebufferScale};
+    accumulator.Add(rect, sizeof(rect));
+
+    for (const ImDrawList* list : draw_data->CmdLists) {
+        accumulator.Add(list->CmdBuffer.Data, list->CmdBuffer.size_in_bytes());
+        accumulator.Add(list->VtxBuffer.Data, list->VtxBuffer.size_in_bytes());
+        accumulator.Add(list->IdxBuffer.Data, list->IdxBuffer.size_in_bytes());
+        length = length * Prime2 + ((uint64_t)list->CmdBuffer.Size << 42 ^ (uint64_t)list->VtxBuffer.Size << 21 ^ (uint64_t)list->IdxBuffer.Size);
+    }
+
+    const uint64_t hash = accumulator.Finish(length);
+    return hash ? hash : 1;
+}
+
+uint64_t HashBytes(const void* bytes, size_t size)
+{
+    Accumulator accumulator;
+    accumulator.Add(bytes, size);
+
+    const uint64_t hash = accumulator.Finish(size);
+    return hash ? hash : 1;
+}
+
+} // namespace CatMenu
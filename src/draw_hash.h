@@ -0,0 +1,17 @@
+#pragma once
+
+#include "imgui.h"
+
+namespace CatMenu
+{
+
+// 64-bit hash of everything a renderer uploads or draws from: display rect, and per draw list
+// its command, vertex and index buffers. Equal hashes mean the frame can be drawn from the
+// buffers uploaded for the last one. Not for adversarial input; never 0, so 0 can stand for
+// "not hashed".
+uint64_t HashDrawData(const ImDrawData* draw_data);
+
+// The same hash over a plain buffer, e.g. a rendered image.
+uint64_t HashBytes(const void* bytes, size_t size);
+
+} // namespace CatMenu
@@ -0,0 +1,124 @@
+#include "frame_budget.h"
+
+#include <ImGuiNotify.hpp>
+
+namespace CatMenu
+{
+
+void FrameBudget::Apply(const Config& config)
+{
+    const float budget = config.budget_ms;
+    if (budget <= 0.0f || calls.empty()) {
+        calls.clear();
+        return;
+    }
+
+    float pass_ms = 0.0f;
+    for (const auto& call : calls)
+        pass_ms += call.ms;
+
+    // Only judge funcs when the pass as a whole is over budget, so one heavy plugin among
+    // otherwise cheap ones is left alone as long as the frame fits.
+    const bool  over_budget = pass_ms > budget;
+    const float share       = budget / (float)calls.size();
+    const int   leak        = std::max(config.recovery / std::max(config.strikes, 1), 1); // calls per leaked strike
+
+    for (const auto& call : calls) {
+        auto& state = *call.entry->state;
+
+        if (!over_budget || call.ms <= share) {
+            if (state.strikes && ++state.leak_calls >= leak) {
+                state.leak_calls = 0;
+                --state.strikes;
+            }
+            if (++state.good_calls < config.recovery)
+                continue;
+
+            state.good_calls = 0;
+            state.strikes    = 0;
+            state.leak_calls = 0;
+            state.warned     = false;
+            if (state.demoted_interval > 1) {
+                state.demoted_interval /= 2;
+                logger::info("Overlay: {} is within the frame budget again, update interval is now {}.", call.entry->label, state.demoted_interval);
+            }
+            continue;
+        }
+
+        state.good_calls = 0;
+        if (++state.strikes < config.strikes)
+            continue;
+        state.strikes    = 0;
+        state.leak_calls = 0;
+
+        if (call.overlay) {
+            const auto max_interval = (uint32_t)std::max(config.max_interval, 1);
+            if (state.demoted_interval >= max_interval)
+                continue;
+
+            state.demoted_interval = std::min(state.demoted_interval * 2, max_interval);
+
+            auto msg = std::format("Overlay: {} keeps exceeding the frame budget ({:.2f} ms of {:.2f} ms).\nNow updating every {} frames.",
+                                   call.entry->label, call.ms, budget, state.demoted_interval);
+            logger::warn("{}", msg);
+            ImGui::InsertNotification({ImGuiToastType::Warning, 5000, msg.c_str()});
+        } else if (!state.warned) {
+            state.warned = true;
+
+            auto msg = std::format("Menu: {} keeps exceeding the frame budget ({:.2f} ms of {:.2f} ms).", call.entry->label, call.ms, budget);
+            logger::warn("{}", msg);
+            ImGui::InsertNotification({ImGuiToastType::Warning, 5000, msg.c_str()});
+        }
+    }
+
+    calls.clear();
+}
+
+void FrameBudget::DrawState(const DrawFuncList& draw_funcs)
+{
+    if (!ImGui::TreeNode("Current State"))
+        return;
+
+    if (ImGui::BeginTable("Frame Budget Table", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Interval", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Strikes", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableHeadersRow();
+
+        auto row = [&](const DrawEntry& entry, const char* kind) {
+            const auto& state = *entry.state;
+            if (state.demoted_interval == 1 && !state.strikes && !state.warned)
+                return;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s: %s", kind, entry.label);
+            ImGui::TableNextColumn();
+            if (state.warned)
+                ImGui::TextUnformatted("warned");
+            else
+                ImGui::Text("%u", std::max(entry.update_interval, state.demoted_interval));
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", state.strikes);
+        };
+        for (const auto& overlay : draw_funcs.overlays)
+            row(overlay, "Overlay");
+        for (const auto& menu : draw_funcs.menus)
+            row(menu, "Menu");
+
+        ImGui::EndTable();
+    }
+    ImGui::TextDisabled("Only draw funcs that exceeded their share are listed.");
+
+    ImGui::TreePop();
+}
+
+void FrameBudget::Shrink(size_t capacity)
+{
+    if (calls.capacity() > capacity) {
+        std::vector<Call>{}.swap(calls);
+        calls.reserve(capacity);
+    }
+}
+
+} // namespace CatMenu
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "registry.h"
+
+namespace CatMenu
+{
+
+// CPU budget for a frame's overlay and menu pass. Draw funcs are only judged when the pass as a
+// whole is over budget, each against an equal share of it: an overlay that keeps exceeding its
+// share has its update interval doubled, a menu is warned about once, and either is let off a
+// step after a long run within its share. Strikes leak away, one per recovery / strikes calls
+// within the share, so only funcs that exceed it more often than that are ever demoted.
+// Menus are not demoted: they are interactive and have no cached lists to show in between calls,
+// so calling them less often would make their windows flicker and drop input.
+// The state is kept on each DrawFunc, so it outlives snapshots. Used by the thread building frames.
+class FrameBudget
+{
+public:
+    struct Config
+    {
+        float budget_ms;    // for the whole pass, 0 to disable
+        int   strikes;      // calls over their share before an overlay is demoted or a menu warned about
+        int   recovery;     // calls in a row within their share before that is undone a step
+        int   max_interval; // slowest update interval a demoted overlay can reach
+    };
+
+    // After each draw func call of the pass.
+    void Record(const DrawEntry& entry, float ms, bool overlay) { calls.push_back({&entry, ms, overlay}); }
+
+    // Once the pass is done, judges the calls recorded since the last Apply.
+    void Apply(const Config& config);
+
+    // "Current State" tree node: the funcs demoted, warned about or collecting strikes.
+    static void DrawState(const DrawFuncList& draw_funcs);
+
+    size_t GetMemory() const { return calls.capacity() * sizeof(Call); }
+    void   Shrink(size_t capacity); // releases the storage for more calls than that
+
+private:
+    struct Call
+    {
+        const DrawEntry* entry;
+        float            ms;
+        bool             overlay;
+    };
+    std::vector<Call> calls; // this pass
+};
+
+} // namespace CatMenu
@@ -0,0 +1,25 @@
+#include "frame_clock.h"
+
+namespace CatMenu
+{
+
+void FrameClock::Tick()
+{
+    auto fake   = source.load(std::memory_order_relaxed);
+    auto sample = (fake ? fake() : Clock::now()).time_since_epoch().count();
+
+    auto last = now.exchange(sample, std::memory_order_relaxed);
+    if (frame.fetch_add(1, std::memory_order_relaxed) == 0) {
+        start.store(sample, std::memory_order_relaxed);
+        last = sample;
+    }
+    delta.store(std::chrono::duration<float>(Clock::duration{sample - last}).count(), std::memory_order_relaxed);
+}
+
+double FrameClock::GetTime() const
+{
+    const auto elapsed = now.load(std::memory_order_relaxed) - start.load(std::memory_order_relaxed);
+    return std::chrono::duration<double>(Clock::duration{elapsed}).count();
+}
+
+} // namespace CatMenu
@@ -0,0 +1,36 @@
+#pragma once
+
+namespace CatMenu
+{
+
+// One steady_clock sample per UI::Draw, shared by everything that animates or times out
+// (ImGui, notifications, the overlay refresh cap) and by plugins through the API, so all of a
+// frame agrees on its time and the OS clock is read once.
+// Ticked by the render thread; readable from any thread.
+class FrameClock
+{
+public:
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Source    = TimePoint (*)();
+
+    void Tick();
+
+    TimePoint Now() const { return TimePoint{Clock::duration{now.load(std::memory_order_relaxed)}}; }
+    uint64_t  GetFrameIndex() const { return frame.load(std::memory_order_relaxed); } // ticks so far
+    float     GetDeltaTime() const { return delta.load(std::memory_order_relaxed); }  // seconds since the previous tick
+    double    GetTime() const;                                                        // seconds since the first tick
+
+    // Replaces steady_clock::now, e.g. with a fixed step for deterministic runs. nullptr
+    // restores the real clock. A fake clock must not return the epoch.
+    void SetSource(Source fake) { source.store(fake, std::memory_order_relaxed); }
+
+private:
+    std::atomic<Source>               source = nullptr;
+    std::atomic<Clock::duration::rep> now    = 0;
+    std::atomic<Clock::duration::rep> start  = 0;
+    std::atomic<uint64_t>             frame  = 0;
+    std::atomic<float>                delta  = 0.0f;
+};
+
+} // namespace CatMenu
@@ -0,0 +1,79 @@
+#include "frame_pipeline.h"
+
+namespace CatMenu
+{
+
+void FramePipeline::Start(BuildFunc build_func, ImGuiContext* context)
+{
+    build  = std::move(build_func);
+    thread = std::jthread([this, context](std::stop_token stop) { Run(stop, context); });
+}
+
+FramePipeline::Frame FramePipeline::Acquire(const std::function<bool()>& refresh_due, const std::function<bool()>& prepare)
+{
+    bool fresh  = false;
+    bool capped = false; // resubmitting on purpose, not a reused frame
+    {
+        std::unique_lock lock{mutex};
+
+        // Only called while the pipeline thread is parked, i.e. no frame is requested.
+        auto flip = [&]() {
+            if (!back_ready)
+                return;
+            front      = 1 - front;
+            back_ready = false;
+            fresh      = true;
+        };
+
+        if (!requested) {
+            flip();
+            capped = !refresh_due();
+        }
+        if (!requested && !capped) {
+            if (prepare()) {
+                snapshots[front].Clear();
+                hashes[front] = 0;
+            }
+            requested = true;
+            cv.notify_one();
+        }
+
+        // A late frame keeps building and is picked up by a later Acquire.
+        const float deadline = deadline_ms.load(std::memory_order_relaxed);
+        if (deadline > 0.0f) {
+            if (completed.wait_for(lock, std::chrono::duration<float, std::milli>(deadline), [this] { return !requested; }))
+                flip();
+            else
+                late_frames.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    const Frame frame{snapshots[front].Get(), hashes[front]};
+    if (frame.draw_data && !fresh && !capped)
+        reused_frames.fetch_add(1, std::memory_order_relaxed);
+    return frame;
+}
+
+void FramePipeline::Run(std::stop_token stop, ImGuiContext* context)
+{
+    // The shared current context is switched by everyone on the render thread, the game's other
+    // ImGui users included, while frames are built here. See imgui_config.h.
+    CatMenu_SetThreadLocalContext(true);
+    ImGui::SetCurrentContext(context);
+
+    std::unique_lock lock{mutex};
+    while (cv.wait(lock, stop, [this] { return requested; })) {
+        auto& back = snapshots[1 - front];
+        lock.unlock();
+
+        const uint64_t hash = build(back);
+
+        lock.lock();
+        hashes[1 - front] = hash;
+        back_ready        = true;
+        requested         = false;
+        completed.notify_all();
+    }
+}
+
+} // namespace CatMenu
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "draw_data.h"
+
+namespace CatMenu
+{
+
+// Pipelined mode: a dedicated thread builds frames into snapshots, and the render thread only
+// submits the latest completed one. Costs one frame of latency, unless a deadline is set: then
+// the render thread waits up to that long for the frame it just requested, and resubmits the
+// previous one if it is late.
+class FramePipeline
+{
+public:
+    // Builds a frame into back, cleared if there is nothing to draw, and returns its hash, see
+    // HashDrawData. Runs on the pipeline thread.
+    using BuildFunc = std::function<uint64_t(DrawDataSnapshot& back)>;
+
+    struct Frame
+    {
+        ImDrawData* draw_data = nullptr; // nullptr if there is nothing to submit
+        uint64_t    hash      = 0;
+    };
+
+    // Starts the pipeline thread, once. It builds in context, as its own current context.
+    void Start(BuildFunc build_func, ImGuiContext* context);
+    bool IsRunning() const { return thread.joinable(); }
+
+    // Render thread, once per frame. Unless a frame is still building, picks up the last completed
+    // one and, if refresh_due, runs prepare with the pipeline thread parked and requests the next;
+    // prepare returns true if the frame picked up references resources it released. Then waits
+    // up to the deadline for the frame requested.
+    Frame Acquire(const std::function<bool()>& refresh_due, const std::function<bool()>& prepare);
+
+    // Render thread, the time the backend took to submit the frame from Acquire.
+    void RecordSubmit(float ms) { submit_ms.store(ms, std::memory_order_relaxed); }
+
+    // Pipeline thread: the time recorded by the render thread, and the deadline it waits with.
+    float GetSubmitMs() const { return submit_ms.load(std::memory_order_relaxed); }
+    void  SetDeadline(float ms) { deadline_ms.store(ms, std::memory_order_relaxed); }
+
+    uint64_t GetLateFrameCount() const { return late_frames.load(std::memory_order_relaxed); } // any thread
+    uint64_t GetReusedFrameCount() const { return reused_frames.load(std::memory_order_relaxed); }
+
+private:
+    void Run(std::stop_token stop, ImGuiContext* context);
+
+    BuildFunc                       build;
+    std::mutex                      mutex;
+    std::condition_variable_any     cv;        // frame requested
+    std::condition_variable_any     completed; // frame built
+    bool                            requested  = false; // guarded by mutex: the pipeline thread is building a frame
+    bool                            back_ready = false; // guarded by mutex
+    int                             front      = 0;     // only changed while the pipeline thread is parked
+    std::array<DrawDataSnapshot, 2> snapshots;
+    std::array<uint64_t, 2>         hashes        = {};   // of the snapshots, written with them
+    std::atomic<float>              submit_ms     = 0.0f; // RenderDrawData time
+    std::atomic<float>              deadline_ms   = 0.0f; // 0 to never wait
+    std::atomic<uint64_t>           late_frames   = 0;    // deadline passed before the frame was built
+    std::atomic<uint64_t>           reused_frames = 0;    // a frame was submitted again
+
+    std::jthread thread; // declared last, so it is joined before anything it uses is destroyed
+};
+
+} // namespace CatMenu
@@ -0,0 +1,36 @@
+#pragma once
+
+// ImGui user config (IMGUI_USER_CONFIG), applied to imgui.dll and everything built against it.
+//
+// The current context is shared by all threads, as in stock ImGui, except where a thread opts in
+// to a context of its own with CatMenu_SetThreadLocalContext. CatMenu's workers do so while they
+// build a plugin context (see PluginContext::Build), so several can be built at once, and the
+// pipeline thread for good (see FramePipeline), so the game's ImGui users switching the shared
+// context on the render thread cannot pull a frame being built over to theirs. Inside
+// ImGui, GImGui reads the thread's own context first and falls back to the shared one; code
+// outside of it goes through ImGui::GetCurrentContext(), since a thread_local cannot be imported
+// from a DLL. Plugins built without this config read the exported GImGui, i.e. the shared
+// context, so they see what they always did, but their draw funcs in plugin contexts need this
+// config to see the plugin context.
+
+struct ImGuiContext;
+
+#ifndef IMGUI_API
+#    define IMGUI_API
+#endif
+
+// While enabled, SetCurrentContext on the calling thread only changes its own context, which
+// starts out as none (reading the shared one). Disabling drops it; enabling again keeps it.
+// Returns whether it was enabled.
+IMGUI_API bool CatMenu_SetThreadLocalContext(bool enable);
+
+#ifdef CATMENU_IMGUI_IMPL
+extern thread_local ImGuiContext* GImGuiTLS;
+extern IMGUI_API ImGuiContext*    GImGui;
+#    define GImGui (GImGuiTLS ? GImGuiTLS : GImGui) // not expanded again inside, so the fallback is the variable
+
+void CatMenu_SetCurrentContext(ImGuiContext* ctx);
+#    define IMGUI_SET_CURRENT_CONTEXT_FUNC CatMenu_SetCurrentContext
+#else
+#    define GImGui ImGui::GetCurrentContext()
+#endif
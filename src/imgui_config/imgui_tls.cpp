@@ -0,0 +1,26 @@
+#include "imgui.h"
+
+thread_local ImGuiContext* GImGuiTLS        = nullptr;
+thread_local bool          g_thread_context = false;
+
+// Also the legacy export for plugins compiled without imgui_config.h, see there.
+#undef GImGui
+IMGUI_API ImGuiContext* GImGui = nullptr;
+
+void CatMenu_SetCurrentContext(ImGuiContext* ctx)
+{
+    if (g_thread_context)
+        GImGuiTLS = ctx;
+    else
+        GImGui = ctx;
+}
+
+bool CatMenu_SetThreadLocalContext(bool enable)
+{
+    const bool was_enabled = g_thread_context;
+    if (enable != was_enabled) {
+        g_thread_context = enable;
+        GImGuiTLS        = nullptr;
+    }
+    return was_enabled;
+}
@@ -11,7 +11,7 @@
 namespace CatMenu
 {
 
-const ImGuiKey VirtualKeyToImGuiKey(WPARAM vkKey)
+ImGuiKey VirtualKeyToImGuiKey(WPARAM vkKey)
 {
     switch (vkKey) {
         case VK_TAB:
@@ -227,7 +227,7 @@ const ImGuiKey VirtualKeyToImGuiKey(WPARAM vkKey)
     };
 }
 
-const uint32_t DIKToVK(uint32_t DIK)
+uint32_t DIKToVK(uint32_t DIK)
 {
     switch (DIK) {
         case DIK_LEFTARROW:
@@ -290,6 +290,32 @@ const uint32_t DIKToVK(uint32_t DIK)
 }
 
 
+uint32_t ScanCodeToVK(uint32_t id_code)
+{
+    uint32_t key = DIKToVK(id_code);
+    if (key == id_code)
+        key = MapVirtualKeyEx(id_code, MAPVK_VSC_TO_VK_EX, GetKeyboardLayout(0));
+    return key;
+}
+
+ImGuiKeyChord VirtualKeyToImGuiMod(uint32_t vkKey)
+{
+    switch (vkKey) {
+        case VK_LCONTROL:
+        case VK_RCONTROL:
+            return ImGuiMod_Ctrl;
+        case VK_LSHIFT:
+        case VK_RSHIFT:
+            return ImGuiMod_Shift;
+        case VK_LMENU:
+        case VK_RMENU:
+            return ImGuiMod_Alt;
+        default:
+            return ImGuiMod_None;
+    }
+}
+
+
 void InputHandler::BSInputDeviceManager_PollInputDevices::thunk(RE::BSTEventSource<RE::InputEvent*>* a_dispatcher, RE::InputEvent* const* a_events)
 {
     auto& queue_mutex = InputHandler::GetSingleton()->event_queue_mutex;
@@ -334,6 +360,12 @@ void InputHandler::BSInputDeviceManager_PollInputDevices::thunk(RE::BSTEventSour
     return;
 }
 
+void InputHandler::QueueFocusLost()
+{
+    std::lock_guard lock{event_queue_mutex};
+    focus_lost = true;
+}
+
 void InputHandler::ProcessEvents()
 {
     std::lock_guard lock{event_queue_mutex};
@@ -341,6 +373,15 @@ void InputHandler::ProcessEvents()
     last_key_pressed = ImGuiKey_None;
     ImGuiIO& io      = ImGui::GetIO();
 
+    if (idle) {
+        // ImGui missed the releases while idle; modifiers are still tracked, so put those back
+        idle = false;
+        io.ClearInputKeys();
+        for (auto mod : {ImGuiMod_Ctrl, ImGuiMod_Shift, ImGuiMod_Alt})
+            if (held_mods & mod)
+                io.AddKeyEvent(ImGuiKey{mod}, true);
+    }
+
     for (auto event : event_queue) {
         if (event.type == RE::INPUT_EVENT_TYPE::kChar) {
             io.AddInputCharacter(event.id_code);
@@ -357,19 +398,14 @@ void InputHandler::ProcessEvents()
                     io.AddMouseButtonEvent(event.id_code, event.IsPressed());
                 }
             } else if (event.device == RE::INPUT_DEVICE::kKeyboard) {
-                uint32_t key = DIKToVK(event.id_code);
-                if (key == event.id_code)
-                    key = MapVirtualKeyEx(event.id_code, MAPVK_VSC_TO_VK_EX, GetKeyboardLayout(0));
+                uint32_t key = ScanCodeToVK(event.id_code);
 
                 auto imgui_key = VirtualKeyToImGuiKey(key);
                 io.AddKeyEvent(imgui_key, event.IsPressed());
 
-                if (key == VK_LCONTROL || key == VK_RCONTROL) {
-                    io.AddKeyEvent(ImGuiMod_Ctrl, event.IsPressed());
-                } else if (key == VK_LSHIFT || key == VK_RSHIFT) {
-                    io.AddKeyEvent(ImGuiMod_Shift, event.IsPressed());
-                } else if (key == VK_LMENU || key == VK_RMENU) {
-                    io.AddKeyEvent(ImGuiMod_Alt, event.IsPressed());
+                if (auto mod = VirtualKeyToImGuiMod(key)) {
+                    io.AddKeyEvent(ImGuiKey{mod}, event.IsPressed());
+                    held_mods = event.IsPressed() ? held_mods | mod : held_mods & ~mod;
                 } else {
                     int mod_key = imgui_key;
                     if (ImGui::IsKeyDown(ImGuiKey_ModCtrl))
@@ -385,6 +421,41 @@ void InputHandler::ProcessEvents()
     }
 
     event_queue.clear();
+
+    if (focus_lost) {
+        focus_lost = false;
+        held_mods  = ImGuiMod_None;
+        io.AddFocusEvent(false); // releases held keys at the next NewFrame
+    }
+}
+
+bool InputHandler::ProcessEventsIdle(ImGuiKeyChord toggle_key)
+{
+    std::lock_guard lock{event_queue_mutex};
+
+    last_key_pressed = ImGuiKey_None;
+    bool toggled     = false;
+
+    for (const auto& event : event_queue) {
+        if (event.type != RE::INPUT_EVENT_TYPE::kButton || event.device != RE::INPUT_DEVICE::kKeyboard)
+            continue;
+        if (event.IsPressed() && !event.IsDown())
+            continue;
+
+        uint32_t key = ScanCodeToVK(event.id_code);
+        if (auto mod = VirtualKeyToImGuiMod(key))
+            held_mods = event.IsPressed() ? held_mods | mod : held_mods & ~mod;
+        else if (event.IsPressed() && (VirtualKeyToImGuiKey(key) | held_mods) == toggle_key)
+            toggled = true;
+    }
+
+    event_queue.clear();
+    idle = true;
+
+    // ImGui gets the focus event with the next built frame
+    if (focus_lost)
+        held_mods = ImGuiMod_None;
+    return toggled;
 }
 
 } // namespace CatMenu
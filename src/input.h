@@ -8,7 +8,8 @@ namespace CatMenu
 class InputHandler
 {
 private:
-    ImGuiKey last_key_pressed = ImGuiKey_None;
+    ImGuiKey      last_key_pressed = ImGuiKey_None;
+    ImGuiKeyChord held_mods        = ImGuiMod_None; // tracked here too, ImGui's state is stale while idle
 
     struct KeyEvent
     {
@@ -38,6 +39,8 @@ private:
     };
     std::mutex            event_queue_mutex;
     std::vector<KeyEvent> event_queue;
+    bool                  focus_lost = false; // queued too, applied after the events before it
+    bool                  idle       = false; // events were drained without ImGui, see ProcessEventsIdle
 
 public:
     static InputHandler* GetSingleton()
@@ -49,6 +52,15 @@ public:
     inline ImGuiKey GetLastKeyPressed() { return last_key_pressed; }
     void            ProcessEvents();
 
+    // The game window lost focus: keys held now will not be released. Any thread; like key
+    // events, it reaches ImGui from the thread building frames, which may be mid-frame now.
+    void QueueFocusLost();
+
+    // Drains the queue without an ImGui frame. Returns whether toggle_key was pressed. The keys
+    // and mouse buttons ImGui still holds are released by the next ProcessEvents, as their
+    // release events were drained too.
+    bool ProcessEventsIdle(ImGuiKeyChord toggle_key);
+
     struct BSInputDeviceManager_PollInputDevices
     {
         static void                                    thunk(RE::BSTEventSource<RE::InputEvent*>* a_dispatcher, RE::InputEvent* const* a_events);
@@ -48,6 +48,9 @@ SKSEPluginLoad(const SKSE::LoadInterface* a_skse)
 
     SKSE::Init(a_skse);
 
+    if (auto log_directory = logger::log_directory())
+        CatMenu::UI::GetSingleton()->SetOutputDirectory(std::move(*log_directory)); // traces and draw captures go next to the log
+
     CatMenu::D3DInitHook::install();
 
     auto messaging = SKSE::GetMessagingInterface();
@@ -37,11 +37,44 @@ namespace CatMenu
 
 constexpr REL::Version API_VER = {2, 0, 0, 0};
 
+// Additions after 2.0 only append to the vtable and are counted by the revision, not the version:
+// plugins built against 2.0 compare GetVersion for equality, so it stays 2.0.0.0. The "2.N"
+// sections below are revision N. Builds without the GetAPIRevision export are revision 0.
+constexpr uint32_t API_REVISION = 7;
+
 enum class APIResult : uint8_t
 {
     OK,
     AlreadyRegistered,
     NotRegistered,
+    InvalidHandle, // 2.2: never issued, already removed, or of the wrong type
+};
+
+// 2.2: identifies one registered draw func. A handle stays valid until the func is removed;
+// after that it is rejected, even if its slot has been reused by another registration.
+struct DrawFuncHandle
+{
+    uint32_t index      = 0;
+    uint32_t generation = 0; // 0 is never issued
+
+    constexpr bool IsValid() const { return generation != 0; }
+};
+
+class PluginContext; // 2.4: opaque
+
+// 2.7: what one built UI frame cost and produced
+struct RenderStats
+{
+    uint64_t frame        = 0; // frame index, see APIBase::GetFrameIndex
+    uint32_t draw_lists   = 0; // submitted, including plugin contexts' and cached overlays'
+    uint32_t draw_cmds    = 0;
+    uint32_t vertices     = 0;
+    uint32_t indices      = 0;
+    uint32_t windows      = 0; // active in CatMenu's context
+    uint32_t toasts       = 0;
+    uint32_t input_events = 0; // queued into CatMenu's context
+    float    build_ms     = 0.0f; // CPU time building the frame, draw funcs included
+    float    submit_ms    = 0.0f; // CPU time handing the previous frame to the renderer
 };
 
 class APIBase
@@ -53,11 +86,81 @@ public:
     virtual APIResult     RegisterOverlayDrawFunc(const RE::BSString& name, bool (*func)()) = 0;
     virtual APIResult     RegisterMenuDrawFunc(const RE::BSString& name, bool (*func)())    = 0;
     virtual void          InsertNotification(const ImGuiToast& toast)                       = 0;
+
+    // 2.1
+    // Calls func once every update_interval frames. On the frames in between, the windows it
+    // drew last time are redrawn from a copy of their draw lists, beneath all live windows.
+    // Suitable for overlays showing slowly changing data (compass, bars, clock).
+    virtual APIResult RegisterCachedOverlayDrawFunc(const RE::BSString& name, bool (*func)(), uint32_t update_interval) = 0;
+
+    // 2.2
+    // Same as the Register functions, but return a handle, or an invalid one if the name is taken.
+    // Overlays start enabled, menus start closed. Swapping two funcs of the same type swaps their
+    // draw order (and the order of menus in the Windows menu); removing one leaves the order of
+    // the others as it was. Call RemoveDrawFunc before your plugin unloads.
+    virtual DrawFuncHandle AddOverlayDrawFunc(const RE::BSString& name, bool (*func)(), uint32_t update_interval) = 0;
+    virtual DrawFuncHandle AddMenuDrawFunc(const RE::BSString& name, bool (*func)())                             = 0;
+    virtual APIResult      RemoveDrawFunc(DrawFuncHandle handle)                                                  = 0;
+    virtual APIResult      SetDrawFuncEnabled(DrawFuncHandle handle, bool enabled)                                = 0;
+    virtual APIResult      SwapDrawFuncOrder(DrawFuncHandle a, DrawFuncHandle b)                                  = 0;
+
+    // 2.3
+    // Overlay with an update phase. update runs on a CatMenu worker thread after the frame is
+    // presented, while the game simulates, and fills the buffer it is given. draw runs on the
+    // render thread as usual and gets the buffer of the last completed update; it is not called
+    // before the first update completes. update never receives the buffer draw is reading.
+    // Both buffers are owned by the plugin and must stay alive until RemoveDrawFunc returns.
+    // update must only touch game data that is safe to read off the main thread.
+    virtual DrawFuncHandle AddUpdatedOverlayDrawFunc(const RE::BSString& name, void (*update)(void* back), bool (*draw)(const void* front),
+                                                     void* buffer_a, void* buffer_b, uint32_t update_interval) = 0;
+
+    // 2.4
+    // Opt-in private ImGui context, sharing CatMenu's fonts and style. Draw funcs added to it run
+    // with it current, on a CatMenu worker thread, in parallel with CatMenu and other plugins'
+    // contexts. Its windows are drawn above CatMenu's unless CatMenu was clicked last, the last
+    // clicked context on top; it gets mouse input while its windows are under the cursor, and
+    // keyboard input after it was clicked. Its draw funcs must not use other ImGui contexts or
+    // call back into this API, and must only touch game data that is safe to read off the render
+    // thread. Returns nullptr if the name is taken. Contexts live until the game exits.
+    // The plugin must be built with CatMenu's imgui_config.h (IMGUI_USER_CONFIG): the context is
+    // current only on the worker building it, which code reading ImGui's legacy GImGui does not see.
+    virtual PluginContext* CreatePluginContext(const RE::BSString& name)                                                = 0;
+    virtual DrawFuncHandle AddContextOverlayDrawFunc(PluginContext* context, const RE::BSString& name, bool (*func)()) = 0;
+    virtual DrawFuncHandle AddContextMenuDrawFunc(PluginContext* context, const RE::BSString& name, bool (*func)())    = 0;
+
+    // 2.5
+    // Whether the func showed any window contents on the last frame: false if it is disabled,
+    // was not called (e.g. a menu while CatMenu is closed), or all its windows skipped their
+    // items, i.e. were collapsed, hidden for the frame or in background dock tabs. A func that begins no window
+    // counts as visible when called. Check it before gathering data for a window that would not
+    // be shown anyway.
+    // Only funcs (outside of plugin contexts) whose windows all stay in background dock tabs are
+    // eventually not called at all, until one of their tabs is selected again. Funcs with
+    // collapsed or hidden windows keep being called, as those windows need Begin to reappear.
+    virtual bool IsDrawFuncVisible(DrawFuncHandle handle) = 0;
+
+    // 2.6
+    // CatMenu's frame clock, sampled once per rendered frame. Use it instead of reading the OS
+    // clock so animations and timeouts agree with CatMenu's and with each other. Delta time is
+    // since the last rendered frame, and may be shorter than ImGui's own while the menu is
+    // closed and frames are reused. Time is in seconds since the first frame.
+    virtual uint64_t GetFrameIndex() = 0;
+    virtual float    GetDeltaTime()  = 0;
+    virtual double   GetTime()       = 0;
+
+    // 2.7
+    // Copies the stats of up to count of the most recently built frames into out, oldest first,
+    // and returns how many were copied. The last 240 are kept; frames that were skipped while
+    // idle or resubmitted under the refresh cap are not built and have no entry.
+    virtual uint32_t GetRenderStats(RenderStats* out, uint32_t count) = 0;
 };
 
-[[nodiscard]] inline std::variant<APIBase*, std::string> RequestCatMenuAPI()
+// min_revision: the newest section of this header the plugin calls into. Lower it to keep working
+// with older CatMenu builds when the newer functions are optional.
+[[nodiscard]] inline std::variant<APIBase*, std::string> RequestCatMenuAPI(uint32_t min_revision = API_REVISION)
 {
     typedef APIBase* (*_RequestCatMenuAPIFunc)();
+    typedef uint32_t (*_GetCatMenuAPIRevisionFunc)();
 
     auto plugin_handle = GetModuleHandle(L"CatMenu.dll");
     if (!plugin_handle)
@@ -67,10 +170,14 @@ public:
     if (requestAPIFunc) {
         auto api     = requestAPIFunc();
         auto api_ver = api->GetVersion();
-        if (api_ver == API_VER)
-            return api;
-        else
+        if (api_ver != API_VER)
             return std::format("Version mismatch! Requested {}. Get {}.", API_VER, api_ver);
+
+        auto     revisionFunc = (_GetCatMenuAPIRevisionFunc)GetProcAddress(plugin_handle, "GetAPIRevision");
+        uint32_t revision     = revisionFunc ? revisionFunc() : 0;
+        if (revision < min_revision)
+            return std::format("Revision mismatch! Requested {}.{}. Get {}.{}.", API_VER.major(), min_revision, API_VER.major(), revision);
+        return api;
     }
 
     return "Failed to get.";
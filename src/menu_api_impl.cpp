@@ -12,7 +12,7 @@ REL::Version API::GetVersion()
 }
 ImGuiContext* API::GetContext()
 {
-    return ImGui::GetCurrentContext();
+    return UI::GetSingleton()->GetContext();
 }
 
 APIResult API::RegisterOverlayDrawFunc(const RE::BSString& name, bool (*func)())
@@ -30,10 +30,91 @@ void API::InsertNotification(const ImGuiToast& toast)
     ImGui::InsertNotification(toast);
 }
 
+APIResult API::RegisterCachedOverlayDrawFunc(const RE::BSString& name, bool (*func)(), uint32_t update_interval)
+{
+    return UI::GetSingleton()->RegisterOverlayDrawFunc(name, func, update_interval);
+}
+
+DrawFuncHandle API::AddOverlayDrawFunc(const RE::BSString& name, bool (*func)(), uint32_t update_interval)
+{
+    return UI::GetSingleton()->AddOverlayDrawFunc(name, func, update_interval);
+}
+
+DrawFuncHandle API::AddMenuDrawFunc(const RE::BSString& name, bool (*func)())
+{
+    return UI::GetSingleton()->AddMenuDrawFunc(name, func);
+}
+
+APIResult API::RemoveDrawFunc(DrawFuncHandle handle)
+{
+    return UI::GetSingleton()->RemoveDrawFunc(handle);
+}
+
+APIResult API::SetDrawFuncEnabled(DrawFuncHandle handle, bool enabled)
+{
+    return UI::GetSingleton()->SetDrawFuncEnabled(handle, enabled);
+}
+
+APIResult API::SwapDrawFuncOrder(DrawFuncHandle a, DrawFuncHandle b)
+{
+    return UI::GetSingleton()->SwapDrawFuncOrder(a, b);
+}
+
+DrawFuncHandle API::AddUpdatedOverlayDrawFunc(const RE::BSString& name, void (*update)(void* back), bool (*draw)(const void* front),
+                                              void* buffer_a, void* buffer_b, uint32_t update_interval)
+{
+    return UI::GetSingleton()->AddUpdatedOverlayDrawFunc(name, update, draw, buffer_a, buffer_b, update_interval);
+}
+
+PluginContext* API::CreatePluginContext(const RE::BSString& name)
+{
+    return UI::GetSingleton()->CreatePluginContext(name);
+}
+
+DrawFuncHandle API::AddContextOverlayDrawFunc(PluginContext* context, const RE::BSString& name, bool (*func)())
+{
+    return UI::GetSingleton()->AddOverlayDrawFunc(name, func, 1, nullptr, context);
+}
+
+DrawFuncHandle API::AddContextMenuDrawFunc(PluginContext* context, const RE::BSString& name, bool (*func)())
+{
+    return UI::GetSingleton()->AddMenuDrawFunc(name, func, context);
+}
+
+bool API::IsDrawFuncVisible(DrawFuncHandle handle)
+{
+    return UI::GetSingleton()->IsDrawFuncVisible(handle);
+}
+
+uint64_t API::GetFrameIndex()
+{
+    return UI::GetSingleton()->GetFrameClock().GetFrameIndex();
+}
+
+float API::GetDeltaTime()
+{
+    return UI::GetSingleton()->GetFrameClock().GetDeltaTime();
+}
+
+double API::GetTime()
+{
+    return UI::GetSingleton()->GetFrameClock().GetTime();
+}
+
+uint32_t API::GetRenderStats(RenderStats* out, uint32_t count)
+{
+    return UI::GetSingleton()->GetRenderStats(out, count);
+}
+
 
 extern "C" __declspec(dllexport) APIBase* GetAPI()
 {
     return API::GetSingleton();
 }
 
+extern "C" __declspec(dllexport) uint32_t GetAPIRevision()
+{
+    return API_REVISION;
+}
+
 } // namespace CatMenu
@@ -18,6 +18,29 @@ public:
     virtual APIResult     RegisterOverlayDrawFunc(const RE::BSString& name, bool (*func)()) override;
     virtual APIResult     RegisterMenuDrawFunc(const RE::BSString& name, bool (*func)()) override;
     virtual void          InsertNotification(const ImGuiToast& toast) override;
+
+    virtual APIResult RegisterCachedOverlayDrawFunc(const RE::BSString& name, bool (*func)(), uint32_t update_interval) override;
+
+    virtual DrawFuncHandle AddOverlayDrawFunc(const RE::BSString& name, bool (*func)(), uint32_t update_interval) override;
+    virtual DrawFuncHandle AddMenuDrawFunc(const RE::BSString& name, bool (*func)()) override;
+    virtual APIResult      RemoveDrawFunc(DrawFuncHandle handle) override;
+    virtual APIResult      SetDrawFuncEnabled(DrawFuncHandle handle, bool enabled) override;
+    virtual APIResult      SwapDrawFuncOrder(DrawFuncHandle a, DrawFuncHandle b) override;
+
+    virtual DrawFuncHandle AddUpdatedOverlayDrawFunc(const RE::BSString& name, void (*update)(void* back), bool (*draw)(const void* front),
+                                                     void* buffer_a, void* buffer_b, uint32_t update_interval) override;
+
+    virtual PluginContext* CreatePluginContext(const RE::BSString& name) override;
+    virtual DrawFuncHandle AddContextOverlayDrawFunc(PluginContext* context, const RE::BSString& name, bool (*func)()) override;
+    virtual DrawFuncHandle AddContextMenuDrawFunc(PluginContext* context, const RE::BSString& name, bool (*func)()) override;
+
+    virtual bool IsDrawFuncVisible(DrawFuncHandle handle) override;
+
+    virtual uint64_t GetFrameIndex() override;
+    virtual float    GetDeltaTime() override;
+    virtual double   GetTime() override;
+
+    virtual uint32_t GetRenderStats(RenderStats* out, uint32_t count) override;
 };
 
 } // namespace CatMenu
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "plugin_context.h"
+
+#include "context_memory.h"
+
+#include <imgui_internal.h>
+
+namespace CatMenu
+{
+
+PluginContext::PluginContext(std::string_view name) :
+    name(name)
+{
+    // next to CatMenu's imgui.ini
+    ini_path = "imgui_";
+    for (char c : name)
+        ini_path += std::isalnum((unsigned char)c) ? c : '_';
+    ini_path += ".ini";
+}
+
+PluginContext::~PluginContext()
+{
+    if (context)
+        ImGui::DestroyContext(context);
+    atlas.Fonts.clear(); // CatMenu's, not to be deleted with the view
+}
+
+void PluginContext::Prepare(ImGuiContext* main, ImFont* main_font, uint32_t frame)
+{
+    const auto& main_io = main->IO;
+
+    // NewFrame and EndFrame write Locked into the context's atlas, which would race with the other
+    // contexts if they shared CatMenu's. The view holds the same fonts, which point back to
+    // CatMenu's atlas for the texture and glyphs, so only the flag is written here. Copied every
+    // frame to follow font rebuilds; no pixels, so nothing is owned but the vector, which only
+    // allocates when the font count grows.
+    const auto& main_atlas = *main_io.Fonts;
+    atlas.Flags            = main_atlas.Flags;
+    atlas.TexID            = main_atlas.TexID;
+    atlas.TexReady         = main_atlas.TexReady;
+    atlas.TexWidth         = main_atlas.TexWidth;
+    atlas.TexHeight        = main_atlas.TexHeight;
+    atlas.TexUvScale       = main_atlas.TexUvScale;
+    atlas.TexUvWhitePixel  = main_atlas.TexUvWhitePixel;
+    atlas.Fonts.resize(main_atlas.Fonts.Size); // unlike operator=, keeps the existing allocation
+    std::ranges::copy(main_atlas.Fonts, atlas.Fonts.begin());
+    std::ranges::copy(main_atlas.TexUvLines, atlas.TexUvLines);
+
+    if (!context) {
+        context = ImGui::CreateContext(&atlas); // restores the current context
+
+        auto& io        = context->IO;
+        io.IniFilename  = ini_path.c_str();
+        io.ConfigFlags  = main_io.ConfigFlags;
+        io.BackendFlags = main_io.BackendFlags;
+    }
+
+    auto& io                   = context->IO;
+    io.DisplaySize             = main_io.DisplaySize;
+    io.DisplayFramebufferScale = main_io.DisplayFramebufferScale;
+    io.DeltaTime               = main_io.DeltaTime > 0.0f ? main_io.DeltaTime : 1.0f / 60.0f;
+    context->Style             = main->Style;
+
+    font          = main_font;
+    draw_data     = nullptr;
+    visible_frame = frame;
+    overlays.clear();
+    menus.clear();
+}
+
+void PluginContext::Build()
+{
+    const auto start = Profiler::Clock::now();
+
+    // this thread's own current context, the others keep theirs, see imgui_config.h; the
+    // pipeline thread already has one, CatMenu's
+    ImGuiContext* prev      = ImGui::GetCurrentContext();
+    const bool    was_local = CatMenu_SetThreadLocalContext(true);
+    ImGui::SetCurrentContext(context);
+    ImGui::NewFrame();
+
+    if (font)
+        ImGui::PushFont(font);
+
+    auto& g = *context;
+    for (auto overlay : overlays) {
+        const int begin_order = g.WindowsActiveCount;
+        ImGui::PushOverrideID(overlay->id);
+        overlay->func();
+        ImGui::PopID();
+        calls.push_back({begin_order, g.WindowsActiveCount, overlay->state});
+    }
+    for (auto menu : menus) {
+        const int begin_order = g.WindowsActiveCount;
+        ImGui::PushOverrideID(menu->id);
+        menu->state->enabled = menu->func();
+        ImGui::PopID();
+        calls.push_back({begin_order, g.WindowsActiveCount, menu->state});
+    }
+
+    if (font)
+        ImGui::PopFont();
+
+    ImGui::Render();
+    draw_data = ImGui::GetDrawData();
+
+    UpdateVisibility(calls, visible_frame);
+    calls.clear();
+
+    if (was_local)
+        ImGui::SetCurrentContext(prev);
+    else
+        CatMenu_SetThreadLocalContext(false); // back to the shared one, CatMenu's when built on the render thread
+
+    build_ms = std::chrono::duration<float, std::milli>(Profiler::Clock::now() - start).count();
+}
+
+bool PluginContext::HitTest(ImVec2 pos) const
+{
+    if (!context)
+        return false;
+
+    // Active still describes the last frame until the next NewFrame
+    for (ImGuiWindow* window : context->Windows)
+        if (window->Active && !window->Hidden && !(window->Flags & ImGuiWindowFlags_NoMouseInputs) && window->Rect().Contains(pos))
+            return true;
+    return false;
+}
+
+void PluginContext::ForwardEvent(const ImGuiInputEvent& event)
+{
+    // ImGuiIO's Add functions queue into their own context, not the current one
+    auto& io = context->IO;
+    switch (event.Type) {
+        case ImGuiInputEventType_MouseWheel:
+            io.AddMouseWheelEvent(event.MouseWheel.WheelX, event.MouseWheel.WheelY);
+            break;
+        case ImGuiInputEventType_MouseButton:
+            io.AddMouseButtonEvent(event.MouseButton.Button, event.MouseButton.Down);
+            break;
+        case ImGuiInputEventType_Key:
+            io.AddKeyAnalogEvent(event.Key.Key, event.Key.Down, event.Key.AnalogValue);
+            break;
+        case ImGuiInputEventType_Text:
+            io.AddInputCharacter(event.Text.Char);
+            break;
+        case ImGuiInputEventType_Focus:
+            io.AddFocusEvent(event.AppFocused.Focused);
+            break;
+        default:
+            break;
+    }
+}
+
+void PluginContext::SetMousePos(ImVec2 pos)
+{
+    context->IO.AddMousePosEvent(pos.x, pos.y); // filters out repeats
+}
+
+void PluginContext::ClearKeys()
+{
+    context->IO.ClearInputCharacters();
+    context->IO.ClearInputKeys();
+}
+
+void PluginContext::Compact(bool all)
+{
+    CompactContext(context, all);
+}
+
+size_t PluginContext::GetMemory() const
+{
+    return GetContextMemory(context);
+}
+
+} // namespace CatMenu
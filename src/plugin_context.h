@@ -0,0 +1,70 @@
+#pragma once
+
+#include "imgui.h"
+
+#include "profiler.h"
+#include "registry.h"
+
+struct ImGuiContext;
+struct ImGuiInputEvent;
+
+namespace CatMenu
+{
+
+// A plugin's own ImGui context, sharing CatMenu's fonts and style.
+// Each frame the drawing thread prepares every context that has funcs to draw, the contexts are
+// built on workers while CatMenu builds its own, and their draw lists are merged into CatMenu's
+// draw data. Input is routed to one context at a time, see UI::RouteInput.
+class PluginContext
+{
+public:
+    explicit PluginContext(std::string_view name);
+    ~PluginContext();
+
+    PluginContext(const PluginContext&)            = delete;
+    PluginContext& operator=(const PluginContext&) = delete;
+
+    const std::string& GetName() const { return name; }
+
+    // Drawing thread, before CatMenu's NewFrame. Creates the context on first use, copies the
+    // main context's display size, delta time, style and fonts, and empties the func lists. frame
+    // is recorded as the funcs' visible frame, see UpdateVisibility.
+    void Prepare(ImGuiContext* main, ImFont* font, uint32_t frame);
+
+    // Any thread, as long as no other thread touches this context. Runs one frame.
+    void Build();
+
+    // nullptr until built; valid until the next Build
+    ImDrawData* GetDrawData() const { return draw_data; }
+
+    // Drawing thread, between Prepare and Build.
+    bool HitTest(ImVec2 pos) const; // a window of the last frame takes the mouse at pos
+    void ForwardEvent(const ImGuiInputEvent& event);
+    void SetMousePos(ImVec2 pos); // -FLT_MAX to leave nothing hovered
+    void ClearKeys();
+
+    // Drawing thread, between frames. See CompactContext.
+    void   Compact(bool all);
+    size_t GetMemory() const;
+
+    std::vector<const DrawEntry*> overlays; // funcs to call this frame, filled between Prepare and Build
+    std::vector<const DrawEntry*> menus;
+    int                           frame = -1; // main context frame the lists were filled for
+
+    std::atomic<bool> building = false; // set while a worker runs Build
+    float             build_ms = 0.0f;
+    Profiler::ZoneId  zone     = Profiler::InvalidZone;
+
+private:
+    std::string   name;
+    std::string   ini_path; // window positions, per plugin
+    ImFontAtlas   atlas;    // a view of CatMenu's, see Prepare
+    ImGuiContext* context   = nullptr;
+    ImFont*       font      = nullptr;
+    ImDrawData*   draw_data = nullptr;
+
+    std::vector<DrawCall> calls;
+    uint32_t              visible_frame = 0;
+};
+
+} // namespace CatMenu
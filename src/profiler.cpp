@@ -0,0 +1,193 @@
+#include "profiler.h"
+
+namespace CatMenu
+{
+
+Profiler::ZoneId Profiler::AddZone(std::string name)
+{
+    if (!free_zones.empty()) {
+        const ZoneId zone = free_zones.back();
+        free_zones.pop_back();
+        zones[zone] = {std::move(name)};
+        return zone;
+    }
+    zones.push_back({std::move(name)});
+    return (ZoneId)(zones.size() - 1);
+}
+
+void Profiler::RemoveZone(ZoneId zone)
+{
+    if (zone >= zones.size() || zones[zone].removed)
+        return;
+
+    // events of the old zone still in the trace ring are dumped under the name of the next one
+    zones[zone]         = {};
+    zones[zone].removed = true;
+    free_zones.push_back(zone);
+}
+
+void Profiler::Record(ZoneId zone, float ms)
+{
+    if (zone >= zones.size())
+        return;
+
+    auto& z           = zones[zone];
+    z.samples[z.head] = ms;
+    z.head            = (z.head + 1) % HistorySize;
+    z.count           = std::min(z.count + 1, HistorySize);
+}
+
+void Profiler::Record(ZoneId zone, Clock::time_point begin, Clock::time_point end)
+{
+    Record(zone, std::chrono::duration<float, std::milli>(end - begin).count());
+    trace.Push(zone, begin, end);
+}
+
+void Profiler::SnapshotTrace(TraceSnapshot& snapshot, float seconds) const
+{
+    trace.Snapshot(snapshot, seconds);
+    snapshot.zone_names.resize(zones.size());
+    for (size_t i = 0; i < zones.size(); ++i)
+        snapshot.zone_names[i] = zones[i].name; // reuses the strings' capacity
+}
+
+float Profiler::GetLast(ZoneId zone) const
+{
+    if (zone >= zones.size() || !zones[zone].count)
+        return 0.0f;
+
+    const auto& z = zones[zone];
+    return z.samples[(z.head + HistorySize - 1) % HistorySize];
+}
+
+Profiler::CounterId Profiler::AddCounter(std::string name)
+{
+    counters.emplace_back(std::move(name));
+    return (CounterId)(counters.size() - 1);
+}
+
+Profiler::ZoneStats Profiler::ComputeStats(ZoneId zone)
+{
+    const auto& z = zones[zone];
+    if (!z.count)
+        return {zone, 0.0f, 0.0f, 0.0f, 0.0f};
+
+    sorted.assign(z.samples.begin(), z.samples.begin() + z.count);
+
+    float sum = 0.0f;
+    for (float sample : sorted)
+        sum += sample;
+
+    auto p99_it = sorted.begin() + std::min(z.count - 1, z.count * 99 / 100);
+    std::nth_element(sorted.begin(), p99_it, sorted.end());
+
+    return {
+        zone,
+        z.samples[(z.head + HistorySize - 1) % HistorySize],
+        *std::min_element(sorted.begin(), sorted.end()),
+        sum / (float)z.count,
+        *p99_it};
+}
+
+void Profiler::DrawWindow(bool* p_open)
+{
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos({viewport->WorkSize.x * 0.3f, viewport->WorkSize.y * 0.3f}, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize({viewport->WorkSize.x * 0.4f, viewport->WorkSize.y * 0.4f}, ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin("[CatMenu] Performance", p_open)) {
+        ImGui::End();
+        return;
+    }
+
+    if (!counters.empty() && ImGui::BeginTable("Counters", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+        ImGui::TableSetupColumn("Counter", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableHeadersRow();
+
+        for (const auto& counter : counters) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(counter.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)counter.value.load(std::memory_order_relaxed));
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::TextWrapped("CPU time spent building and submitting frames, in milliseconds over the last %d calls.", HistorySize);
+
+    constexpr ImGuiTableFlags table_flags =
+        ImGuiTableFlags_Sortable |
+        ImGuiTableFlags_Resizable |
+        ImGuiTableFlags_RowBg |
+        ImGuiTableFlags_BordersInnerV |
+        ImGuiTableFlags_ScrollY;
+
+    if (ImGui::BeginTable("Zones", 6, table_flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Last", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Min", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Avg", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("P99", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+        ImGui::TableSetupColumn("History", ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_NoSort);
+        ImGui::TableHeadersRow();
+
+        stats.clear();
+        for (ZoneId zone = 0; zone < zones.size(); ++zone)
+            if (!zones[zone].removed)
+                stats.push_back(ComputeStats(zone));
+
+        if (auto sort_specs = ImGui::TableGetSortSpecs(); sort_specs && sort_specs->SpecsCount > 0) {
+            const auto& spec       = sort_specs->Specs[0];
+            const bool  descending = spec.SortDirection == ImGuiSortDirection_Descending;
+
+            auto key = [&](const ZoneStats& s) {
+                switch (spec.ColumnIndex) {
+                    case 1: return s.last;
+                    case 2: return s.min;
+                    case 3: return s.avg;
+                    default: return s.p99;
+                }
+            };
+
+            if (spec.ColumnIndex == 0)
+                std::ranges::sort(stats, [&](const ZoneStats& a, const ZoneStats& b) {
+                    return descending ? zones[b.zone].name < zones[a.zone].name : zones[a.zone].name < zones[b.zone].name;
+                });
+            else
+                std::ranges::sort(stats, [&](const ZoneStats& a, const ZoneStats& b) {
+                    return descending ? key(b) < key(a) : key(a) < key(b);
+                });
+        }
+
+        for (const auto& s : stats) {
+            const auto& z = zones[s.zone];
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(z.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", s.last);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", s.min);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", s.avg);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", s.p99);
+            ImGui::TableNextColumn();
+            ImGui::PushID((int)s.zone);
+            ImGui::PlotLines("##History", z.samples.data(), z.count, z.count < HistorySize ? 0 : z.head,
+                             nullptr, 0.0f, FLT_MAX, ImVec2(-FLT_MIN, ImGui::GetTextLineHeight()));
+            ImGui::PopID();
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+} // namespace CatMenu
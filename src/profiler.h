@@ -0,0 +1,94 @@
+#pragma once
+
+#include "imgui.h"
+
+#include "trace.h"
+
+namespace CatMenu
+{
+
+// CPU timings of the frame loop, one zone per built-in step / registered draw func, plus
+// event counters. Timed zones also go to a TraceRing, to be dumped when looking into a hitch.
+// Owned by the thread building frames (UI::BuildFrame): the render thread, or the pipeline thread
+// when the UI is pipelined. Zones are added lazily and removed from there, so no locking is needed. Counters
+// are added before the first frame; reading them is safe from any thread, as is pushing to the
+// trace ring.
+class Profiler
+{
+public:
+    using ZoneId    = uint32_t;
+    using CounterId = uint32_t;
+
+    static constexpr ZoneId InvalidZone = UINT32_MAX;
+    static constexpr int    HistorySize = 240; // samples kept per zone
+
+    using Clock = std::chrono::steady_clock;
+
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(Profiler& profiler, ZoneId zone) :
+            profiler(profiler), zone(zone), start(Clock::now()) {}
+        ~ScopedTimer() { profiler.Record(zone, start, Clock::now()); }
+
+        ScopedTimer(const ScopedTimer&)            = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Profiler&         profiler;
+        ZoneId            zone;
+        Clock::time_point start;
+    };
+
+    ZoneId AddZone(std::string name);
+    void   RemoveZone(ZoneId zone); // its id is handed out again by a later AddZone
+    void   Record(ZoneId zone, float ms);
+    void   Record(ZoneId zone, Clock::time_point begin, Clock::time_point end); // also traced
+    float  GetLast(ZoneId zone) const;
+
+    TraceRing& GetTrace() { return trace; }
+    void       SnapshotTrace(TraceSnapshot& snapshot, float seconds) const; // see TraceRing::Snapshot, with zone names
+
+    CounterId AddCounter(std::string name);
+    void      Count(CounterId counter, uint64_t n = 1) { counters[counter].value.fetch_add(n, std::memory_order_relaxed); }
+    void      SetCount(CounterId counter, uint64_t value) { counters[counter].value.store(value, std::memory_order_relaxed); }
+    uint64_t  GetCount(CounterId counter) const { return counters[counter].value.load(std::memory_order_relaxed); }
+
+    void DrawWindow(bool* p_open);
+
+private:
+    struct Zone
+    {
+        std::string                    name;
+        std::array<float, HistorySize> samples{}; // ms, ring buffer
+        int                            head    = 0; // next write
+        int                            count   = 0;
+        bool                           removed = false;
+    };
+    std::vector<Zone>   zones;
+    std::vector<ZoneId> free_zones; // removed, to be reused
+    TraceRing           trace;
+
+    struct Counter
+    {
+        std::string           name;
+        std::atomic<uint64_t> value = 0;
+
+        explicit Counter(std::string name) :
+            name(std::move(name)) {}
+        Counter(Counter&& other) noexcept : // only moved by AddCounter, before anyone reads it
+            name(std::move(other.name)), value(other.value.load(std::memory_order_relaxed)) {}
+    };
+    std::vector<Counter> counters;
+
+    struct ZoneStats
+    {
+        ZoneId zone;
+        float  last, min, avg, p99;
+    };
+    std::vector<ZoneStats> stats;  // scratch for DrawWindow
+    std::vector<float>     sorted; // scratch for percentiles
+    ZoneStats              ComputeStats(ZoneId zone);
+};
+
+} // namespace CatMenu
@@ -0,0 +1,224 @@
+#include "registry.h"
+
+#include <imgui_internal.h>
+
+namespace CatMenu
+{
+
+DrawFuncRegistry::DrawFuncRegistry() :
+    current(new DrawFuncList{})
+{
+}
+
+DrawFuncRegistry::~DrawFuncRegistry()
+{
+    delete current.load();
+}
+
+DrawFuncRegistry::Slot* DrawFuncRegistry::Resolve(DrawFuncHandle handle)
+{
+    if (handle.index >= slots.size())
+        return nullptr;
+
+    auto& slot = slots[handle.index];
+    if (!slot.func || slot.generation != handle.generation)
+        return nullptr;
+    return &slot;
+}
+
+std::unique_ptr<DrawFuncList> DrawFuncRegistry::Copy() const
+{
+    return std::make_unique<DrawFuncList>(*current.load(std::memory_order_relaxed));
+}
+
+void DrawFuncRegistry::Publish(std::unique_ptr<DrawFuncList> next)
+{
+    retired.emplace_back(current.exchange(next.release(), std::memory_order_acq_rel));
+}
+
+DrawFuncHandle DrawFuncRegistry::Add(Type type, std::string_view name, std::function<bool()> func, uint32_t update_interval,
+                                     std::unique_ptr<DrawFuncUpdate> update, PluginContext* context)
+{
+    std::lock_guard lock{write_mutex};
+
+    auto& names = Names(type);
+    if (names.contains(name))
+        return {};
+
+    uint32_t index;
+    if (!free_slots.empty()) {
+        index = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        index = (uint32_t)slots.size();
+        slots.emplace_back();
+    }
+
+    auto& slot         = slots[index];
+    slot.func          = std::make_unique<DrawFunc>();
+    slot.func->name    = name;
+    slot.func->enabled = type == Type::Overlay;
+    slot.func->update  = std::move(update);
+    slot.type          = type;
+
+    auto  next = Copy();
+    auto& rows = Rows(*next, type);
+    slot.row   = (uint32_t)rows.size();
+    rows.push_back({std::move(func), ImHashStr(slot.func->name.c_str()), slot.func->name.c_str(), slot.func.get(), std::max(update_interval, 1u), index, context});
+    names.insert({std::string{name}, index});
+
+    Publish(std::move(next));
+
+    return {index, slot.generation};
+}
+
+APIResult DrawFuncRegistry::Remove(DrawFuncHandle handle)
+{
+    std::lock_guard lock{write_mutex};
+
+    auto slot = Resolve(handle);
+    if (!slot)
+        return APIResult::InvalidHandle;
+
+    auto  next = Copy();
+    auto& rows = Rows(*next, slot->type);
+    // keeps the others in registration order, which is their draw order
+    rows.erase(rows.begin() + slot->row);
+    for (uint32_t row = slot->row; row < rows.size(); ++row)
+        slots[rows[row].slot].row = row;
+
+    // The plugin may free its buffers once this returns.
+    if (auto& update = slot->func->update) {
+        auto expected = DrawFuncUpdate::State::Idle;
+        while (!update->state.compare_exchange_weak(expected, DrawFuncUpdate::State::Removed, std::memory_order_acq_rel)) {
+            expected = DrawFuncUpdate::State::Idle;
+            std::this_thread::yield();
+        }
+    }
+
+    Names(slot->type).erase(slot->func->name);
+    retired_funcs.push_back(std::move(slot->func));
+    if (++slot->generation == 0) // 0 is never handed out
+        slot->generation = 1;
+    free_slots.push_back(handle.index);
+
+    Publish(std::move(next));
+
+    return APIResult::OK;
+}
+
+APIResult DrawFuncRegistry::SetEnabled(DrawFuncHandle handle, bool enabled)
+{
+    std::lock_guard lock{write_mutex};
+
+    auto slot = Resolve(handle);
+    if (!slot)
+        return APIResult::InvalidHandle;
+
+    slot->func->enabled = enabled;
+    return APIResult::OK;
+}
+
+APIResult DrawFuncRegistry::SwapOrder(DrawFuncHandle a, DrawFuncHandle b)
+{
+    std::lock_guard lock{write_mutex};
+
+    auto slot_a = Resolve(a);
+    auto slot_b = Resolve(b);
+    if (!slot_a || !slot_b || slot_a->type != slot_b->type)
+        return APIResult::InvalidHandle;
+    if (slot_a == slot_b)
+        return APIResult::OK;
+
+    auto  next = Copy();
+    auto& rows = Rows(*next, slot_a->type);
+    std::swap(rows[slot_a->row], rows[slot_b->row]);
+    std::swap(slot_a->row, slot_b->row);
+
+    Publish(std::move(next));
+
+    return APIResult::OK;
+}
+
+APIResult DrawFuncRegistry::SetEnabled(Type type, std::string_view name, bool enabled)
+{
+    std::lock_guard lock{write_mutex};
+
+    auto& names = Names(type);
+    auto  it    = names.find(name);
+    if (it == names.end())
+        return APIResult::NotRegistered;
+
+    slots[it->second].func->enabled = enabled;
+    return APIResult::OK;
+}
+
+bool DrawFuncRegistry::IsVisible(DrawFuncHandle handle, uint32_t frame)
+{
+    std::lock_guard lock{write_mutex};
+
+    auto slot = Resolve(handle);
+    return slot && slot->func->enabled.load(std::memory_order_relaxed) &&
+           slot->func->visible_frame.load(std::memory_order_relaxed) >= frame;
+}
+
+const DrawFuncList& DrawFuncRegistry::Acquire(Profiler& profiler)
+{
+    // The previous frame is over, so nothing retired before this point is still being read.
+    // Never wait for a writer here: if one holds the lock, reclaim next frame instead.
+    if (std::unique_lock lock{write_mutex, std::try_to_lock}; lock) {
+        retired.clear();
+        for (const auto& func : retired_funcs)
+            profiler.RemoveZone(func->zone);
+        retired_funcs.clear();
+    }
+
+    return *current.load(std::memory_order_acquire);
+}
+
+bool IsBackgroundDockTab(const ImGuiWindow* window)
+{
+    if (!window->DockId)
+        return false;
+    auto node = ImGui::DockBuilderGetNode(window->DockId); // looked up, the window's node pointer may be stale
+    return node && node->Windows.Size > 1 && node->SelectedTabId != window->TabId;
+}
+
+void UpdateVisibility(std::span<const DrawCall> calls, uint32_t frame)
+{
+    if (calls.empty())
+        return;
+
+    for (const auto& call : calls)
+        call.state->windows.clear();
+
+    auto& g = *ImGui::GetCurrentContext();
+    for (ImGuiWindow* window : g.Windows) {
+        if (!window->Active || window->LastFrameActive != g.FrameCount)
+            continue;
+
+        auto it = std::ranges::upper_bound(calls, (int)window->BeginOrderWithinContext, {}, &DrawCall::begin_order);
+        if (it == calls.begin())
+            continue;
+        --it;
+        if (window->BeginOrderWithinContext < it->end_order)
+            it->state->windows.push_back(window);
+    }
+
+    for (const auto& call : calls) {
+        auto& state   = *call.state;
+        bool  visible = state.windows.empty();
+        bool  tabbed  = !state.windows.empty();
+        for (auto window : state.windows) {
+            visible |= !window->SkipItems; // collapsed, hidden for the frame, or a background tab
+            tabbed &= IsBackgroundDockTab(window);
+        }
+
+        state.visible              = visible;
+        state.background_tab_calls = tabbed ? state.background_tab_calls + 1 : 0;
+        if (visible)
+            state.visible_frame.store(frame, std::memory_order_relaxed);
+    }
+}
+
+} // namespace CatMenu
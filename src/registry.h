@@ -0,0 +1,172 @@
+#pragma once
+
+#include "draw_data.h"
+#include "menu_api.h"
+#include "profiler.h"
+
+struct ImGuiWindow;
+
+namespace CatMenu
+{
+
+class PluginContext;
+
+// Optional update phase of an overlay, run on a worker while the game simulates.
+// The plugin owns both buffers: update writes the back one, draw reads the front one, and the
+// render thread swaps them only when no update is running.
+struct DrawFuncUpdate
+{
+    enum class State : uint8_t
+    {
+        Idle,
+        Busy,   // a worker is writing buffers[1 - front]
+        Removed // never runs again
+    };
+
+    void (*func)(void* back);
+    std::array<void*, 2> buffers;
+
+    std::atomic<State> state = State::Idle;
+
+    // render thread only
+    int  front     = 0;
+    bool submitted = false; // an update was started since the last swap
+    bool ready     = false; // front holds a completed update
+};
+
+// Per-registration state that outlives snapshots.
+struct DrawFunc
+{
+    std::string       name;
+    std::atomic<bool> enabled = true;
+
+    // render thread only
+    Profiler::ZoneId zone = Profiler::InvalidZone; // assigned on first draw
+
+    int                       next_update_frame = 0; // overlays with an update interval
+    DrawListCache             replay;                // lists of the windows drawn on the last update
+    std::vector<ImGuiWindow*> replay_windows;
+
+    // frame budget, see FrameBudget
+    int      strikes          = 0; // calls over their share while the pass was over budget, leaking away
+    int      good_calls       = 0; // consecutive calls since the last strike
+    int      leak_calls       = 0; // calls within their share since a strike last leaked away
+    uint32_t demoted_interval = 1; // overlays only, menus are warned about instead
+    bool     warned           = false;
+
+    // visibility, see UpdateVisibility
+    std::atomic<uint32_t>     visible_frame        = 0;     // last frame it showed any window contents, read by the API
+    bool                      visible              = false; // on its last call
+    int                       background_tab_calls = 0;     // consecutive calls with all its windows in background dock tabs
+    std::vector<ImGuiWindow*> windows;                      // began on its last call
+
+    std::unique_ptr<DrawFuncUpdate> update;
+};
+
+// The windows one call of a draw func began, as a range of ImGuiWindow::BeginOrderWithinContext.
+struct DrawCall
+{
+    int       begin_order;
+    int       end_order;
+    DrawFunc* state;
+};
+
+// After ImGui::Render in the context the calls were made in. Records the windows each call
+// began and whether they were visible, i.e. whether any of them ran its items (no SkipItems:
+// not collapsed, hidden for the frame, or in a background dock tab). A func that began no window
+// (e.g. draws to the background draw list) counts as visible. Also counts the calls in a row
+// with all windows in background dock tabs, the only hidden windows whose func can be skipped: a
+// collapsed window still draws its title bar, and a hidden one reappears from its own Begin.
+// calls are in call order, so sorted and disjoint.
+void UpdateVisibility(std::span<const DrawCall> calls, uint32_t frame);
+
+// A window that is docked, but not in the selected tab of its dock node. Only needs the dock
+// node, so it also works for windows that were not begun this frame.
+bool IsBackgroundDockTab(const ImGuiWindow* window);
+
+// One row of the flat draw table. Holds everything the render loop needs, so a frame is a
+// linear scan with no name lookups or string hashing.
+struct DrawEntry
+{
+    std::function<bool()> func;
+    ImGuiID               id;    // hash of the name, pushed with ImGui::PushOverrideID
+    const char*           label; // points into state->name
+    DrawFunc*             state;
+    uint32_t              update_interval; // frames between calls, overlays only
+    uint32_t              slot;            // owning slot in the registry
+    PluginContext*        context;         // drawn in this context instead of CatMenu's, see PluginContext
+};
+
+// Immutable snapshot of the registered draw funcs, in draw order.
+struct DrawFuncList
+{
+    std::vector<DrawEntry> overlays;
+    std::vector<DrawEntry> menus;
+};
+
+// Read-copy-update registry.
+// Writers (any thread, including from inside a draw func) copy the current list, modify the
+// copy and publish it with an atomic swap. The drawing thread is the only reader: it picks up
+// the latest list once per frame without locking, and because it never holds a list across
+// frames, lists retired by writers can be freed at the start of the next frame.
+//
+// Registrations live in a slot map. A handle is a slot index plus the slot's generation, which
+// is bumped on removal, so handles of removed funcs (e.g. from an unloaded plugin) are rejected
+// even after the slot is reused. Each slot knows its row in the snapshot, so remove (swap with
+// the last row), enable and reorder touch a fixed number of rows; publishing still copies the list.
+class DrawFuncRegistry
+{
+public:
+    enum class Type : uint8_t
+    {
+        Overlay,
+        Menu
+    };
+
+    DrawFuncRegistry();
+    ~DrawFuncRegistry();
+
+    // Returns an invalid handle if the name is already taken.
+    DrawFuncHandle Add(Type type, std::string_view name, std::function<bool()> func, uint32_t update_interval = 1,
+                       std::unique_ptr<DrawFuncUpdate> update = nullptr, PluginContext* context = nullptr);
+    APIResult      Remove(DrawFuncHandle handle); // waits for a running update
+    APIResult      SetEnabled(DrawFuncHandle handle, bool enabled);
+    APIResult      SwapOrder(DrawFuncHandle a, DrawFuncHandle b); // both of the same type
+    bool           IsVisible(DrawFuncHandle handle, uint32_t frame); // enabled, and visible on frame or later
+
+    APIResult SetEnabled(Type type, std::string_view name, bool enabled);
+
+    // Drawing thread only (the render thread, or the UI thread in pipelined mode).
+    // The returned list stays valid until the next call. The zones of removed funcs are removed
+    // from profiler once the last frame referencing them is over.
+    const DrawFuncList& Acquire(Profiler& profiler);
+
+private:
+    struct Slot
+    {
+        std::unique_ptr<DrawFunc> func; // null while free
+        uint32_t                  generation = 1;
+        uint32_t                  row        = 0; // index into the snapshot's overlays/menus
+        Type                      type       = Type::Overlay;
+    };
+
+    // guarded by write_mutex
+    std::mutex                                 write_mutex;
+    std::vector<Slot>                          slots;
+    std::vector<uint32_t>                      free_slots;
+    StringMap<uint32_t>                        overlay_names; // name -> slot
+    StringMap<uint32_t>                        menu_names;
+    std::vector<std::unique_ptr<DrawFuncList>> retired;
+    std::vector<std::unique_ptr<DrawFunc>>     retired_funcs; // removed, may still be referenced by the last frame
+
+    std::atomic<DrawFuncList*> current;
+
+    Slot*                         Resolve(DrawFuncHandle handle);
+    std::unique_ptr<DrawFuncList> Copy() const;
+    void                          Publish(std::unique_ptr<DrawFuncList> next);
+
+    static std::vector<DrawEntry>& Rows(DrawFuncList& list, Type type) { return type == Type::Overlay ? list.overlays : list.menus; }
+    StringMap<uint32_t>&           Names(Type type) { return type == Type::Overlay ? overlay_names : menu_names; }
+};
+
+} // namespace CatMenu
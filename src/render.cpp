@@ -1,10 +1,9 @@
 #include "render.h"
 
+#include "input.h"
 #include "ui.h"
 
 #include <Detours/Detours.h>
-#include <imgui_impl_dx11.h>
-#include <imgui_impl_win32.h>
 
 namespace CatMenu
 {
@@ -12,11 +11,9 @@ namespace CatMenu
 LRESULT
 WndProcHook::thunk(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
-    if (uMsg == WM_KILLFOCUS) {
-        auto& io = ImGui::GetIO();
-        io.ClearInputCharacters();
-        io.ClearInputKeys();
-    }
+    // window thread: ImGui may be mid-frame on another one, so this goes through the input queue
+    if (uMsg == WM_KILLFOCUS)
+        InputHandler::GetSingleton()->QueueFocusLost();
 
     return func(hWnd, uMsg, wParam, lParam);
 }
@@ -40,7 +37,7 @@ void D3DInitHook::thunk()
     auto swapchain = reinterpret_cast<IDXGISwapChain*>(manager->GetRuntimeData().renderWindows->swapChain);
     auto device    = reinterpret_cast<ID3D11Device*>(manager->GetRuntimeData().forwarder);
 
-    UI::GetSingleton()->Init(swapchain, device, context);
+    UI::GetSingleton()->Init(std::make_unique<DX11Backend>(swapchain, device, context));
 
     logger::info("Hooking swapchain present...");
     *(uintptr_t*)&ptr_IDXGISwapChain_Present = Detours::X64::DetourClassVTable(*(uintptr_t*)swapchain, &hk_IDXGISwapChain_Present, 8);
@@ -0,0 +1,85 @@
+#include "trace.h"
+
+#include <nlohmann/json.hpp>
+
+namespace CatMenu
+{
+
+static uint32_t GetThreadNumber()
+{
+    // small, stable numbers read better in trace viewers than hashed thread ids
+    static std::atomic<uint32_t> next   = 1;
+    thread_local const uint32_t  number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+TraceRing::TraceRing() :
+    slots(std::make_unique<Slot[]>(Capacity))
+{
+}
+
+void TraceRing::Push(uint32_t zone, Clock::time_point begin, Clock::time_point end)
+{
+    const uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+    auto&          slot  = slots[index % Capacity];
+
+    slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.id.store((uint64_t)zone << 32 | GetThreadNumber(), std::memory_order_relaxed);
+    slot.begin.store(begin.time_since_epoch().count(), std::memory_order_relaxed);
+    slot.end.store(end.time_since_epoch().count(), std::memory_order_relaxed);
+    slot.seq.store(2 * index + 2, std::memory_order_release);
+}
+
+void TraceRing::Snapshot(TraceSnapshot& snapshot, float seconds) const
+{
+    auto& events = snapshot.events;
+    events.clear();
+    events.reserve(Capacity); // once, later snapshots reuse it
+
+    const uint64_t last = head.load(std::memory_order_acquire);
+    for (uint64_t index = last > Capacity ? last - Capacity : 0; index < last; ++index) {
+        const auto&    slot = slots[index % Capacity];
+        const uint64_t seq  = slot.seq.load(std::memory_order_acquire);
+        if (seq != 2 * index + 2)
+            continue; // still being written, or already overwritten
+
+        TraceSnapshot::Event event{slot.id.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == seq)
+            events.push_back(event);
+    }
+    if (events.empty())
+        return;
+
+    const auto newest = std::ranges::max(events, {}, &TraceSnapshot::Event::end).end;
+    const auto cutoff = newest - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(seconds)).count();
+    std::erase_if(events, [cutoff](const TraceSnapshot::Event& event) { return event.end < cutoff; });
+}
+
+bool TraceSnapshot::Write(const std::filesystem::path& path) const
+{
+    if (events.empty())
+        return false;
+
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    const auto origin = std::ranges::min(events, {}, &Event::begin).begin;
+    auto       us     = [](Clock::rep ticks) { return std::chrono::duration<double, std::micro>(Clock::duration{ticks}).count(); };
+    auto       name   = [this](uint32_t zone) { return zone < zone_names.size() ? std::string_view{zone_names[zone]} : "?"sv; };
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        file << std::format("{}\n{{\"name\":{},\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                            i ? "," : "", nlohmann::json(name((uint32_t)(event.id >> 32))).dump(), (uint32_t)event.id,
+                            us(event.begin - origin), us(event.end - event.begin));
+    }
+    file << "\n]}\n";
+
+    return (bool)file;
+}
+
+} // namespace CatMenu
@@ -0,0 +1,59 @@
+#pragma once
+
+namespace CatMenu
+{
+
+// Events copied out of a TraceRing, to be written as Chrome trace JSON (chrome://tracing,
+// Perfetto) off the thread that took them.
+struct TraceSnapshot
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+        uint64_t   id; // zone << 32 | thread
+        Clock::rep begin;
+        Clock::rep end;
+    };
+    std::vector<Event>       events;     // capacity kept between snapshots
+    std::vector<std::string> zone_names; // indexed by zone id
+
+    // Returns false if there were no events or the file could not be written.
+    bool Write(const std::filesystem::path& path) const;
+};
+
+// Flight recorder for profiler zones: keeps the most recent zone begin/end pairs, written
+// lock-free from any thread, and snapshotted to look into hitches after the fact.
+class TraceRing
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint64_t Capacity = 1 << 15; // events, 1 MiB; the oldest are overwritten
+
+    TraceRing();
+
+    TraceRing(const TraceRing&)            = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    // Any thread, never blocks.
+    void Push(uint32_t zone, Clock::time_point begin, Clock::time_point end);
+
+    // Copies the events that ended within the last seconds before the newest one, leaving
+    // snapshot.zone_names alone. Events overwritten while copying are left out.
+    void Snapshot(TraceSnapshot& snapshot, float seconds) const;
+
+private:
+    // seqlock per slot, so a snapshot never reads a half-written event
+    struct Slot
+    {
+        std::atomic<uint64_t>   seq   = 0; // 2 * index + 2 once written, odd while being written
+        std::atomic<uint64_t>   id    = 0; // zone << 32 | thread
+        std::atomic<Clock::rep> begin = 0;
+        std::atomic<Clock::rep> end   = 0;
+    };
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t>   head = 0; // next index to write
+};
+
+} // namespace CatMenu
@@ -1,12 +1,11 @@
 #include "ui.h"
 
 #include "input.h"
+#include "context_memory.h"
+#include "draw_hash.h"
 
-#include <magic_enum.hpp>
 #include <nlohmann/json.hpp>
 #include <imgui_internal.h>
-#include <imgui_impl_dx11.h>
-#include <imgui_impl_win32.h>
 #include <imgui_stdlib.h>
 #include <ImGuiNotify.hpp>
 
@@ -32,6 +31,7 @@ void from_json(const json& j, ImVec4& v)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
     CatMenu::UI::Settings,
     toggle_key,
+    overlay_refresh_rate,
     font_path,
     font_size,
     glyph_chn_full,
@@ -42,200 +42,175 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
     glyph_kor,
     glyph_thai,
     glyph_viet,
+    pipelined_ui,
+    frame_deadline_ms,
+    parallel_contexts,
+    merge_draw_cmds,
+    skip_hidden_after,
+    trim_after_s,
+    show_stats_hud,
+    trace_key,
+    trace_seconds,
+    trace_hitch_ms,
+    capture_frames,
+    buffer_peak_vertices,
+    buffer_peak_indices,
+    frame_budget_ms,
+    budget_strikes,
+    budget_recovery,
+    budget_max_interval,
     theme_colors)
 } // namespace nlohmann
 
-// copied from imgui_impl_dx11.cpp
-
-struct ImGui_ImplDX11_Data
-{
-    ID3D11Device*             pd3dDevice;
-    ID3D11DeviceContext*      pd3dDeviceContext;
-    IDXGIFactory*             pFactory;
-    ID3D11Buffer*             pVB;
-    ID3D11Buffer*             pIB;
-    ID3D11VertexShader*       pVertexShader;
-    ID3D11InputLayout*        pInputLayout;
-    ID3D11Buffer*             pVertexConstantBuffer;
-    ID3D11PixelShader*        pPixelShader;
-    ID3D11SamplerState*       pFontSampler;
-    ID3D11ShaderResourceView* pFontTextureView;
-    ID3D11RasterizerState*    pRasterizerState;
-    ID3D11BlendState*         pBlendState;
-    ID3D11DepthStencilState*  pDepthStencilState;
-    int                       VertexBufferSize;
-    int                       IndexBufferSize;
-
-    ImGui_ImplDX11_Data()
-    {
-        memset((void*)this, 0, sizeof(*this));
-        VertexBufferSize = 5000;
-        IndexBufferSize  = 10000;
-    }
-};
+namespace CatMenu
+{
+
+constexpr auto g_config_path = "Data\\SKSE\\Plugins\\catmenu\\settings.json"sv;
 
-static ImGui_ImplDX11_Data* ImGui_ImplDX11_GetBackendData()
+std::string KeyToString(ImGuiKey key)
 {
-    return ImGui::GetCurrentContext() ? (ImGui_ImplDX11_Data*)ImGui::GetIO().BackendRendererUserData : nullptr;
+    bool ctrl  = (int)key & (int)ImGuiMod_Ctrl;
+    bool shift = (int)key & (int)ImGuiMod_Shift;
+    bool alt   = (int)key & (int)ImGuiMod_Alt;
+    key        = ImGuiKey{(int)key & ~(int)ImGuiMod_Mask_};
+    return (ctrl ? "Ctrl + "s : ""s) + (shift ? "Shift + "s : ""s) + (alt ? "Alt + "s : ""s) + std::string(ImGui::GetKeyName(ImGuiKey{key}));
 }
 
-static void ImGui_ImplDX11_CreateFontsTexture()
-{
-    // Build texture atlas
-    ImGuiIO&             io = ImGui::GetIO();
-    ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
-    unsigned char*       pixels;
-    int                  width, height;
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
 
-    // Upload texture to graphics system
-    {
-        D3D11_TEXTURE2D_DESC desc;
-        ZeroMemory(&desc, sizeof(desc));
-        desc.Width            = width;
-        desc.Height           = height;
-        desc.MipLevels        = 1;
-        desc.ArraySize        = 1;
-        desc.Format           = DXGI_FORMAT_R8G8B8A8_UNORM;
-        desc.SampleDesc.Count = 1;
-        desc.Usage            = D3D11_USAGE_DEFAULT;
-        desc.BindFlags        = D3D11_BIND_SHADER_RESOURCE;
-        desc.CPUAccessFlags   = 0;
-
-        ID3D11Texture2D*       pTexture = nullptr;
-        D3D11_SUBRESOURCE_DATA subResource;
-        subResource.pSysMem          = pixels;
-        subResource.SysMemPitch      = desc.Width * 4;
-        subResource.SysMemSlicePitch = 0;
-        bd->pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
-        IM_ASSERT(pTexture != nullptr);
-
-        // Create texture view
-        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
-        ZeroMemory(&srvDesc, sizeof(srvDesc));
-        srvDesc.Format                    = DXGI_FORMAT_R8G8B8A8_UNORM;
-        srvDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Texture2D.MipLevels       = desc.MipLevels;
-        srvDesc.Texture2D.MostDetailedMip = 0;
-        bd->pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &bd->pFontTextureView);
-        pTexture->Release();
-    }
-
-    // Store our identifier
-    io.Fonts->SetTexID((ImTextureID)bd->pFontTextureView);
-
-    // Create texture sampler
-    // (Bilinear sampling is required by default. Set 'io.Fonts->Flags |= ImFontAtlasFlags_NoBakedLines' or 'style.AntiAliasedLinesUseTex = false' to allow point/nearest sampling)
-    {
-        D3D11_SAMPLER_DESC desc;
-        ZeroMemory(&desc, sizeof(desc));
-        desc.Filter         = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-        desc.AddressU       = D3D11_TEXTURE_ADDRESS_WRAP;
-        desc.AddressV       = D3D11_TEXTURE_ADDRESS_WRAP;
-        desc.AddressW       = D3D11_TEXTURE_ADDRESS_WRAP;
-        desc.MipLODBias     = 0.f;
-        desc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-        desc.MinLOD         = 0.f;
-        desc.MaxLOD         = 0.f;
-        bd->pd3dDevice->CreateSamplerState(&desc, &bd->pFontSampler);
-    }
-}
 
-void ImGui_ImplDX11_ReCreateFontsTexture()
+DrawFuncHandle UI::AddOverlayDrawFunc(std::string_view name, std::function<bool()> func, uint32_t update_interval,
+                                      std::unique_ptr<DrawFuncUpdate> update, PluginContext* context)
 {
-    ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
-
-    if (bd->pFontSampler) {
-        bd->pFontSampler->Release();
-        bd->pFontSampler = NULL;
-    }
-    if (bd->pFontTextureView) {
-        bd->pFontTextureView->Release();
-        bd->pFontTextureView = NULL;
-        ImGui::GetIO().Fonts->SetTexID(NULL);
+    auto handle = registry.Add(DrawFuncRegistry::Type::Overlay, name, std::move(func), update_interval, std::move(update), context);
+    if (!handle.IsValid()) {
+        logger::warn("Trying to register draw func {} which already exists. Aborted.", name);
+        return handle;
     }
-    ImGui_ImplDX11_CreateFontsTexture();
-}
-
 
+    logger::info("Overlay: {} registered.", name);
+    ImGui::InsertNotification({ImGuiToastType::Success, 5000, "Overlay: %s registered.", std::string(name).c_str()});
 
+    return handle;
+}
 
+DrawFuncHandle UI::AddMenuDrawFunc(std::string_view name, std::function<bool()> func, PluginContext* context)
+{
+    auto handle = registry.Add(DrawFuncRegistry::Type::Menu, name, std::move(func), 1, nullptr, context);
+    if (!handle.IsValid()) {
+        logger::warn("Trying to register menu: {}, which already exists. Aborted.", name);
+        return handle;
+    }
 
+    logger::info("Menu: {} registered.", name);
+    ImGui::InsertNotification({ImGuiToastType::Success, 5000, "Menu: %s registered.", std::string(name).c_str()});
 
+    return handle;
+}
 
-namespace CatMenu
+DrawFuncHandle UI::AddUpdatedOverlayDrawFunc(std::string_view name, void (*update)(void* back), bool (*draw)(const void* front),
+                                             void* buffer_a, void* buffer_b, uint32_t update_interval)
 {
+    auto state     = std::make_unique<DrawFuncUpdate>();
+    state->func    = update;
+    state->buffers = {buffer_a, buffer_b};
 
-constexpr auto g_config_path = "Data\\SKSE\\Plugins\\catmenu\\settings.json"sv;
+    // nothing to draw until the first update has completed
+    auto func = [draw, state = state.get()]() { return state->ready ? draw(state->buffers[state->front]) : true; };
+    return AddOverlayDrawFunc(name, std::move(func), update_interval, std::move(state));
+}
 
-std::string KeyToString(ImGuiKey key)
+APIResult UI::RemoveDrawFunc(DrawFuncHandle handle)
 {
-    bool ctrl  = (int)key & (int)ImGuiMod_Ctrl;
-    bool shift = (int)key & (int)ImGuiMod_Shift;
-    bool alt   = (int)key & (int)ImGuiMod_Alt;
-    key        = ImGuiKey{(int)key & ~(int)ImGuiMod_Mask_};
-    return (ctrl ? "Ctrl + "s : ""s) + (shift ? "Shift + "s : ""s) + (alt ? "Alt + "s : ""s) + std::string(ImGui::GetKeyName(ImGuiKey{key}));
+    auto result = registry.Remove(handle);
+    if (result != APIResult::OK)
+        logger::warn("Trying to remove a draw func with an invalid handle ({}, generation {}). Aborted.", handle.index, handle.generation);
+    return result;
 }
 
+APIResult UI::SetDrawFuncEnabled(DrawFuncHandle handle, bool enabled)
+{
+    return registry.SetEnabled(handle, enabled);
+}
+
+APIResult UI::SwapDrawFuncOrder(DrawFuncHandle a, DrawFuncHandle b)
+{
+    return registry.SwapOrder(a, b);
+}
 
+bool UI::IsDrawFuncVisible(DrawFuncHandle handle)
+{
+    return registry.IsVisible(handle, built_frames.load(std::memory_order_relaxed));
+}
 
-APIResult UI::RegisterOverlayDrawFunc(std::string_view name, std::function<bool()> func)
+PluginContext* UI::CreatePluginContext(std::string_view name)
 {
-    std::lock_guard list_lock{list_mutex};
+    std::lock_guard lock{plugin_contexts_mutex};
 
-    if (auto it = menu_list.find(name); it != menu_list.end()) {
-        logger::warn("Trying to register draw func {} which already exists. Aborted.", name);
-        return APIResult::AlreadyRegistered;
+    if (std::ranges::any_of(plugin_contexts, [&](const auto& plugin_context) { return plugin_context->GetName() == name; })) {
+        logger::warn("Trying to create plugin context {} which already exists. Aborted.", name);
+        return nullptr;
     }
 
-    std::string name_str{name};
-    overlay_list.insert({name_str, DrawFunc{name_str, func, true}});
-    overlay_order.push_back(name_str);
-
-    logger::info("Overlay: {} registered.", name);
-    ImGui::InsertNotification({ImGuiToastType::Success, 5000, "Overlay: %s registered.", name.data()});
+    logger::info("Context: {} created.", name);
+    return plugin_contexts.emplace_back(std::make_unique<PluginContext>(name)).get();
+}
 
-    return APIResult::OK;
+APIResult UI::RegisterOverlayDrawFunc(std::string_view name, std::function<bool()> func, uint32_t update_interval)
+{
+    return AddOverlayDrawFunc(name, std::move(func), update_interval).IsValid() ? APIResult::OK : APIResult::AlreadyRegistered;
 }
 
 APIResult UI::RegisterMenuDrawFunc(std::string_view name, std::function<bool()> func)
 {
-    std::lock_guard list_lock{list_mutex};
-
-    if (auto it = menu_list.find(name); it != menu_list.end()) {
-        logger::warn("Trying to register menu: {}, which already exists. Aborted.", name);
-        return APIResult::AlreadyRegistered;
-    }
-
-    std::string name_str{name};
-    menu_list.insert({name_str, DrawFunc{name_str, func, false}});
-    menu_order.push_back(name_str);
-    logger::info("Menu: {} registered.", name);
-    ImGui::InsertNotification({ImGuiToastType::Success, 5000, "Menu: %s registered.", name.data()});
+    return AddMenuDrawFunc(name, std::move(func)).IsValid() ? APIResult::OK : APIResult::AlreadyRegistered;
+}
 
-    return APIResult::OK;
+APIResult UI::SetMenuEnabled(std::string_view name, bool enabled)
+{
+    return registry.SetEnabled(DrawFuncRegistry::Type::Menu, name, enabled);
 }
 
-void UI::Init(IDXGISwapChain* swapchain, ID3D11Device* device, ID3D11DeviceContext* context)
+void UI::Init(std::unique_ptr<RenderBackend> render_backend)
 {
     logger::info("Initializing ImGui...");
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
+    main_context = ImGui::CreateContext();
 
     // Setup Platform/Renderer backends
-    DXGI_SWAP_CHAIN_DESC desc;
-    swapchain->GetDesc(&desc);
-
-    ImGui_ImplWin32_Init(desc.OutputWindow);
-    ImGui_ImplDX11_Init(device, context);
+    backend = std::move(render_backend);
+    backend->Init();
 
     logger::info("ImGui initialized.");
 
+    ///////////////////////// PROFILER
+    zones.frame            = profiler.AddZone("[CatMenu] Frame");
+    zones.process_events   = profiler.AddZone("[CatMenu] ProcessEvents");
+    zones.load_fonts       = profiler.AddZone("[CatMenu] LoadFonts");
+    zones.new_frame        = profiler.AddZone("[CatMenu] NewFrame");
+    zones.render           = profiler.AddZone("[CatMenu] Render");
+    zones.render_draw_data = profiler.AddZone("[CatMenu] RenderDrawData");
+    zones.hash_draw_data   = profiler.AddZone("[CatMenu] HashDrawData");
+    zones.merge_draw_cmds  = profiler.AddZone("[CatMenu] MergeDrawCmds");
+    zones.notifications    = profiler.AddZone("[CatMenu] RenderNotifications");
+    idle_frames            = profiler.AddCounter("Idle frames skipped");
+    late_frames            = profiler.AddCounter("Late frames (pipelined)");
+    reused_frames          = profiler.AddCounter("Reused frames (pipelined)");
+    submits                = profiler.AddCounter("Frames submitted");
+    skipped_uploads        = profiler.AddCounter("Uploads skipped (unchanged draw data)");
+    background_tab_skips   = profiler.AddCounter("Background tab draw func calls skipped");
+    draw_calls_total       = profiler.AddCounter("Draw calls built");
+    merged_calls_total     = profiler.AddCounter("Draw calls after merging");
+
+    workers = std::make_unique<WorkerPool>(std::clamp(std::thread::hardware_concurrency() / 4, 1u, 4u));
+
     ///////////////////////// CONFIG
     LoadSettings();
 
+    if (auto sizer = backend->GetBufferSizer())
+        sizer->Presize(settings.buffer_peak_vertices, settings.buffer_peak_indices);
+
     auto& io = ImGui::GetIO();
 
     io.ConfigFlags  = ImGuiConfigFlags_NavEnableKeyboard | ImGuiConfigFlags_DockingEnable;
@@ -313,36 +288,291 @@ void UI::LoadFonts()
     io.Fonts->Build();
 
     if (is_rebuild)
-        ImGui_ImplDX11_ReCreateFontsTexture();
+        backend->ReCreateFontsTexture();
+    fonts_rebuilt = true;
 
     logger::info("Font {} built.", settings.font_path);
 }
 
+std::string& UI::KeyName::Get(int key)
+{
+    if (of != key) {
+        of   = key;
+        name = KeyToString(ImGuiKey{key});
+    }
+    return name;
+}
+
+void UI::DrawKeyField(const char* label, int& key, KeyName& name)
+{
+    ImGui::InputTextWithHint(label, "Click to set keyboard shortcut", &name.Get(key),
+                             ImGuiInputTextFlags_ReadOnly | ImGuiInputTextFlags_NoUndoRedo | ImGuiInputTextFlags_NoHorizontalScroll);
+    if (ImGui::IsItemActive()) {
+        const auto last_key_pressed = InputHandler::GetSingleton()->GetLastKeyPressed();
+        if (last_key_pressed != ImGuiKey_None) {
+            key = last_key_pressed;
+            ImGui::ClearActiveID();
+        }
+    }
+}
+
+Profiler::ZoneId UI::GetZone(const DrawEntry& entry, std::string_view kind)
+{
+    auto& zone = entry.state->zone;
+    if (zone == Profiler::InvalidZone)
+        zone = profiler.AddZone(std::format("{}: {}", kind, entry.label));
+    return zone;
+}
+
+bool UI::IsIdle(const DrawFuncList& draw_funcs) const
+{
+    return !show_menu && !should_load_fonts && !settings.show_stats_hud && draw_funcs.overlays.empty() && !ImGui::HasNotifications();
+}
+
 void UI::Draw()
 {
-    InputHandler::GetSingleton()->ProcessEvents();
+    // shared with the game's other ImGui users, which may have left theirs current
+    if (ImGui::GetCurrentContext() != main_context)
+        ImGui::SetCurrentContext(main_context);
+
+    clock.Tick();
+
+    // the game's frame time, measured between our calls
+    const float hitch_ms = settings.trace_hitch_ms;
+    if (hitch_ms > 0.0f && clock.GetDeltaTime() * 1000.0f > hitch_ms && clock.Now() >= next_auto_trace) {
+        next_auto_trace = clock.Now() + std::chrono::duration_cast<FrameClock::Clock::duration>(std::chrono::duration<float>(settings.trace_seconds));
+        trace_requested.store(true, std::memory_order_relaxed);
+    }
+
+    if (!pipeline_latched) {
+        pipeline_latched = true;
+        if (settings.pipelined_ui) {
+            logger::info("Starting pipelined UI thread.");
+            pipeline.Start([this](DrawDataSnapshot& back) { return BuildPipelined(back); }, main_context);
+        }
+    }
+
+    if (pipeline.IsRunning()) {
+        DrawPipelined();
+        return;
+    }
+
+    // ImGui's draw data stays intact until the next NewFrame, so it can be submitted again.
+    if (!IsRefreshDue()) {
+        if (submitted_draw_data) {
+            Profiler::ScopedTimer timer{profiler, zones.render_draw_data};
+            Submit(submitted_draw_data, submitted_hash);
+        }
+        capture.Record(submitted_draw_data);
+        return;
+    }
+
+    const auto& draw_funcs = registry.Acquire(profiler);
+
+    submitted_draw_data = BuildFrame(draw_funcs);
+    submitted_hash      = 0;
+    if (submitted_draw_data) {
+        {
+            Profiler::ScopedTimer timer{profiler, zones.hash_draw_data};
+            submitted_hash = HashDrawData(submitted_draw_data);
+        }
+        Profiler::ScopedTimer timer{profiler, zones.render_draw_data};
+        Submit(submitted_draw_data, submitted_hash);
+    }
+    capture.Record(submitted_draw_data);
+
+    KickUpdates(draw_funcs);
+}
+
+void UI::Submit(ImDrawData* draw_data, uint64_t hash)
+{
+    submit_count.fetch_add(1, std::memory_order_relaxed);
+    if (backend->RenderDrawData(draw_data, hash))
+        skipped_upload_count.fetch_add(1, std::memory_order_relaxed);
+}
 
-    if (should_load_fonts)
+bool UI::IsRefreshDue()
+{
+    // On the render thread, also while the pipeline thread builds a frame, so only the rate
+    // published by the last built frame is read here.
+    const int rate = refresh_rate.load(std::memory_order_acquire);
+    if (rate <= 0)
+        return true;
+
+    const auto now = clock.Now();
+    if (now < next_build_time)
+        return false;
+
+    // step by whole periods so the average rate holds even when it does not divide the game's
+    next_build_time = std::max(next_build_time + std::chrono::nanoseconds(1'000'000'000 / rate), now);
+    return true;
+}
+
+void UI::DrawPipelined()
+{
+    auto refresh_due = [this] { return IsRefreshDue(); };
+    auto prepare     = [this] {
+        if (!should_load_fonts)
+            return false;
+
+        // the UI thread is parked, so the font atlas is safe to touch too
+        const auto start = Profiler::Clock::now();
         LoadFonts();
+        profiler.GetTrace().Push(zones.load_fonts, start, Profiler::Clock::now());
+        return true; // the last frame references the released font texture
+    };
+
+    const auto frame    = pipeline.Acquire(refresh_due, prepare);
+    submitted_draw_data = frame.draw_data;
+    submitted_hash      = frame.hash;
+    if (submitted_draw_data) {
+        const auto start = Profiler::Clock::now();
+        Submit(submitted_draw_data, submitted_hash);
+        const auto end = Profiler::Clock::now();
+        pipeline.RecordSubmit(std::chrono::duration<float, std::milli>(end - start).count());
+        profiler.GetTrace().Push(zones.render_draw_data, start, end); // the ring takes any thread
+    }
+    capture.Record(submitted_draw_data);
+}
 
-    ImGui_ImplDX11_NewFrame();
-    ImGui_ImplWin32_NewFrame();
-    ImGui::NewFrame();
+uint64_t UI::BuildPipelined(DrawDataSnapshot& back)
+{
+    profiler.Record(zones.render_draw_data, pipeline.GetSubmitMs());
+    profiler.SetCount(late_frames, pipeline.GetLateFrameCount());
+    profiler.SetCount(reused_frames, pipeline.GetReusedFrameCount());
+    pipeline.SetDeadline(settings.frame_deadline_ms);
+
+    const auto& draw_funcs = registry.Acquire(profiler);
+    if (auto draw_data = BuildFrame(draw_funcs))
+        back.Capture(draw_data);
+    else
+        back.Clear();
+    uint64_t hash = 0;
+    if (back.Get()) { // hashed here, off the render thread
+        Profiler::ScopedTimer timer{profiler, zones.hash_draw_data};
+        hash = HashDrawData(back.Get());
+    }
+    KickUpdates(draw_funcs);
+    return hash;
+}
+
+ImDrawData* UI::BuildFrame(const DrawFuncList& draw_funcs)
+{
+    FinishTraceDump();
+    if (trace_dump.state.load(std::memory_order_acquire) == TraceDump::State::Idle && trace_requested.exchange(false, std::memory_order_relaxed))
+        DumpTrace(); // the frame that asked for it is complete by now
+
+    profiler.SetCount(submits, submit_count.load(std::memory_order_relaxed));
+    profiler.SetCount(skipped_uploads, skipped_upload_count.load(std::memory_order_relaxed));
+
+    const bool idle = IsIdle(draw_funcs);
+    if (trim_time != FrameClock::TimePoint{} && clock.Now() >= trim_time)
+        Trim(draw_funcs, idle);
+
+    if (idle) {
+        if (!InputHandler::GetSingleton()->ProcessEventsIdle(settings.toggle_key)) {
+            profiler.Count(idle_frames);
+            return nullptr;
+        }
+        Toggle(true);
+    }
+
+    Profiler::ScopedTimer frame_timer{profiler, zones.frame};
+    const uint32_t        frame = built_frames.load(std::memory_order_relaxed) + 1;
+    const auto            start = Profiler::Clock::now();
+    RenderStats           stats;
+
+    {
+        Profiler::ScopedTimer timer{profiler, zones.process_events};
+        const int             queued = main_context->InputEventsQueue.Size; // left over from the last frame
+        InputHandler::GetSingleton()->ProcessEvents();
+        stats.input_events = main_context->InputEventsQueue.Size - queued;
+    }
+
+    if (should_load_fonts && !pipeline.IsRunning()) { // pipelined: loaded by the render thread
+        Profiler::ScopedTimer timer{profiler, zones.load_fonts};
+        LoadFonts();
+    }
+
+    if (fonts_rebuilt) {
+        fonts_rebuilt = false;
+
+        // cached overlay lists reference the old font texture and glyph UVs
+        for (const auto& overlay : draw_funcs.overlays)
+            overlay.state->next_update_frame = 0;
+    }
+
+    {
+        Profiler::ScopedTimer timer{profiler, zones.new_frame};
+        backend->NewFrame();
+
+        // must stay positive, even with a fake clock standing still
+        const auto  now = clock.Now();
+        const float dt  = last_build_time == FrameClock::TimePoint{} ? clock.GetDeltaTime() : std::chrono::duration<float>(now - last_build_time).count();
+        ImGui::GetIO().DeltaTime = std::max(dt, 1e-6f);
+        last_build_time          = now;
+
+        PreparePluginContexts(draw_funcs, frame);
+        RouteInput();
+        ImGui::NewFrame();
+        DispatchPluginContexts();
+    }
 
     if (main_font)
         ImGui::PushFont(main_font);
 
     {
-        std::lock_guard list_lock{list_mutex};
+        auto& g = *ImGui::GetCurrentContext();
+        for (const auto& overlay : draw_funcs.overlays) {
+            if (overlay.context || !overlay.state->enabled.load(std::memory_order_relaxed) || SkipBackgroundTabs(overlay))
+                continue;
+
+            const auto interval = std::max(overlay.update_interval, overlay.state->demoted_interval);
+            const bool cached   = interval > 1;
+            if (cached) {
+                auto& state = *overlay.state;
+                if (g.FrameCount < state.next_update_frame) {
+                    // Keep the windows alive so they neither count as appearing (focus, z-order)
+                    // nor get garbage collected when the func runs again.
+                    for (auto window : state.replay_windows) {
+                        window->LastFrameActive = g.FrameCount;
+                        window->LastTimeActive  = (float)g.Time;
+                    }
+                    overlay_replays.push_back(&state);
+                    if (state.visible)
+                        state.visible_frame.store(frame, std::memory_order_relaxed);
+                    continue;
+                }
+                state.next_update_frame = g.FrameCount + (int)interval;
+            }
+
+            // pick up the last completed update, without waiting for a running one
+            if (auto& update = overlay.state->update;
+                update && update->submitted && update->state.load(std::memory_order_acquire) == DrawFuncUpdate::State::Idle) {
+                update->front     = 1 - update->front;
+                update->ready     = true;
+                update->submitted = false;
+            }
 
-        for (std::string_view name : overlay_order) {
-            ImGui::PushID(name.data());
-            overlay_list.at(name).func();
+            const int  begin_order = g.WindowsActiveCount;
+            const auto zone        = GetZone(overlay, "Overlay");
+            ImGui::PushOverrideID(overlay.id);
+            {
+                Profiler::ScopedTimer timer{profiler, zone};
+                overlay.func();
+            }
             ImGui::PopID();
+            budget.Record(overlay, profiler.GetLast(zone), true);
+            draw_calls.push_back({begin_order, g.WindowsActiveCount, overlay.state});
+
+            if (cached)
+                overlay_captures.push_back(overlay.state);
         }
 
         if (ImGui::IsKeyPressed(ImGuiKey{settings.toggle_key}, false))
             Toggle();
+        if (settings.trace_key != ImGuiKey_None && ImGui::IsKeyPressed(ImGuiKey{settings.trace_key}, false))
+            trace_requested.store(true, std::memory_order_relaxed);
 
         auto& io           = ImGui::GetIO();
         io.MouseDrawCursor = show_menu;
@@ -351,17 +581,18 @@ void UI::Draw()
             // menu bar
             if (ImGui::BeginMainMenuBar()) {
                 if (ImGui::BeginMenu("Windows")) {
-                    for (std::string_view name : menu_order) {
-                        auto& menu_func = menu_list.at(name);
-                        ImGui::MenuItem(menu_func.name.c_str(), nullptr, &menu_func.enabled);
+                    for (const auto& menu : draw_funcs.menus) {
+                        bool enabled = menu.state->enabled;
+                        if (ImGui::MenuItem(menu.label, nullptr, &enabled))
+                            menu.state->enabled = enabled;
                     }
 
                     ImGui::Separator();
 
                     if (ImGui::MenuItem("Close Windows")) {
                         show_config = false;
-                        for (auto& [_, menu_func] : menu_list)
-                            menu_func.enabled = false;
+                        for (const auto& menu : draw_funcs.menus)
+                            menu.state->enabled = false;
                     }
                     if (ImGui::IsItemHovered())
                         ImGui::SetTooltip("Close all windows.");
@@ -377,6 +608,8 @@ void UI::Draw()
                 if (ImGui::BeginMenu("Settings")) {
                     ImGui::MenuItem("General", nullptr, &show_config);
                     ImGui::MenuItem("Theme Editor", nullptr, &show_theme_editor);
+                    ImGui::MenuItem("Performance", nullptr, &show_performance);
+                    ImGui::MenuItem("Stats HUD", nullptr, &settings.show_stats_hud);
 
                     ImGui::Separator();
 
@@ -393,7 +626,7 @@ void UI::Draw()
                         auto ver = SKSE::PluginDeclaration::GetSingleton()->GetVersion();
 
                         auto msg = std::format("{}CatMenu version {}.\nProgrammed by FiveLimbedCat/ProfJack.\nPress {} to open the menu",
-                                               g_cat_str, ver, KeyToString(ImGuiKey{settings.toggle_key}));
+                                               g_cat_str, ver, toggle_key_name.Get(settings.toggle_key));
                         ImGui::InsertNotification({ImGuiToastType::Info, 10000, msg.c_str()});
                     }
                     ImGui::EndMenu();
@@ -423,30 +656,437 @@ void UI::Draw()
 
             // default menus
             if (show_config)
-                DrawConfigWindow();
+                DrawConfigWindow(draw_funcs);
             if (show_theme_editor)
                 DrawThemeEditor();
+            if (show_performance)
+                profiler.DrawWindow(&show_performance);
 
             // registered menus
-            for (std::string_view name : menu_order)
-                if (auto& menu_func = menu_list.at(name); menu_func.enabled) {
-                    ImGui::PushID(name.data());
-                    menu_func.enabled = menu_func.func();
+            for (const auto& menu : draw_funcs.menus)
+                if (!menu.context && menu.state->enabled && !SkipBackgroundTabs(menu)) {
+                    const int  begin_order = g.WindowsActiveCount;
+                    const auto zone        = GetZone(menu, "Menu");
+                    ImGui::PushOverrideID(menu.id);
+                    {
+                        Profiler::ScopedTimer timer{profiler, zone};
+                        menu.state->enabled = menu.func();
+                    }
                     ImGui::PopID();
+                    budget.Record(menu, profiler.GetLast(zone), false);
+                    draw_calls.push_back({begin_order, g.WindowsActiveCount, menu.state});
                 }
         }
 
-        ImGui::RenderNotifications(); // <-- Here we render all notifications
+        budget.Apply({settings.frame_budget_ms, settings.budget_strikes, settings.budget_recovery, settings.budget_max_interval});
+
+        if (settings.show_stats_hud)
+            DrawStatsHud();
+
+        Profiler::ScopedTimer timer{profiler, zones.notifications};
+        ImGui::RenderNotifications(clock.Now()); // <-- Here we render all notifications
     }
 
     if (main_font)
         ImGui::PopFont();
 
-    ImGui::Render();
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    {
+        Profiler::ScopedTimer timer{profiler, zones.render};
+        ImGui::Render();
+        UpdateVisibility(draw_calls, frame);
+        draw_calls.clear();
+        CaptureOverlays();
+        ReplayOverlays(ImGui::GetDrawData());
+        MergePluginContexts(ImGui::GetDrawData());
+    }
+
+    // after merging, so plugin contexts and cached overlays are counted
+    ImDrawData* draw_data = ImGui::GetDrawData();
+    stats.frame           = clock.GetFrameIndex();
+    stats.draw_lists      = draw_data->CmdListsCount;
+    stats.vertices        = draw_data->TotalVtxCount;
+    stats.indices         = draw_data->TotalIdxCount;
+    for (const ImDrawList* list : draw_data->CmdLists)
+        stats.draw_cmds += list->CmdBuffer.Size;
+
+    last_draw_calls = last_merged_calls = CountDrawCalls(draw_data);
+    if (settings.merge_draw_cmds) {
+        Profiler::ScopedTimer timer{profiler, zones.merge_draw_cmds};
+        draw_data         = draw_cmd_merger.Merge(draw_data);
+        last_merged_calls = CountDrawCalls(draw_data);
+    }
+    profiler.Count(draw_calls_total, last_draw_calls);
+    profiler.Count(merged_calls_total, last_merged_calls);
+
+    stats.windows   = main_context->WindowsActiveCount;
+    stats.toasts    = (uint32_t)ImGui::GetNotificationCount();
+    stats.build_ms  = std::chrono::duration<float, std::milli>(Profiler::Clock::now() - start).count();
+    stats.submit_ms = profiler.GetLast(zones.render_draw_data);
+    RecordRenderStats(stats);
+
+    refresh_rate.store(show_menu || should_load_fonts ? 0 : settings.overlay_refresh_rate, std::memory_order_release);
+    built_frames.store(frame, std::memory_order_relaxed);
+    return draw_data;
 }
 
-void UI::DrawConfigWindow()
+void UI::RecordRenderStats(const RenderStats& stats)
+{
+    std::lock_guard lock(render_stats_mutex);
+    render_stats[render_stats_head] = stats;
+    render_stats_head               = (render_stats_head + 1) % Profiler::HistorySize;
+    render_stats_count              = std::min(render_stats_count + 1, Profiler::HistorySize);
+}
+
+uint32_t UI::GetRenderStats(RenderStats* out, uint32_t count)
+{
+    std::lock_guard lock(render_stats_mutex);
+    const int       n = (int)std::min<uint32_t>(count, render_stats_count);
+    for (int i = 0; i < n; ++i)
+        out[i] = render_stats[(render_stats_head - n + i + Profiler::HistorySize) % Profiler::HistorySize];
+    return (uint32_t)n;
+}
+
+void UI::DrawStatsHud()
+{
+    // written on this thread, so reading needs no lock
+    if (!render_stats_count)
+        return;
+    const auto& last = render_stats[(render_stats_head + Profiler::HistorySize - 1) % Profiler::HistorySize];
+
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos({viewport->WorkPos.x + 10.0f, viewport->WorkPos.y + 10.0f});
+    ImGui::SetNextWindowBgAlpha(0.6f);
+
+    constexpr auto flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoNav |
+                           ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoDocking;
+    if (ImGui::Begin("[CatMenu] Stats", nullptr, flags)) {
+        ImGui::Text("Build %.2f ms, submit %.2f ms", last.build_ms, last.submit_ms);
+        ImGui::Text("%u lists, %u cmds, %u vtx, %u idx", last.draw_lists, last.draw_cmds, last.vertices, last.indices);
+        if (settings.merge_draw_cmds)
+            ImGui::Text("%u draw calls, %u merged", last_draw_calls, last_merged_calls);
+        else
+            ImGui::Text("%u draw calls", last_draw_calls);
+        ImGui::Text("%u windows, %u toasts, %u input events", last.windows, last.toasts, last.input_events);
+        if (const uint64_t submitted = GetSubmitCount())
+            ImGui::Text("Uploads skipped: %.1f%%", 100.0 * GetSkippedUploadCount() / submitted);
+
+        auto build_ms = [](void* data, int i) {
+            auto ui = static_cast<UI*>(data);
+            return ui->render_stats[(ui->render_stats_head - ui->render_stats_count + i + Profiler::HistorySize) % Profiler::HistorySize].build_ms;
+        };
+        ImGui::PlotLines("##Build", build_ms, this, render_stats_count, 0, nullptr, 0.0f, FLT_MAX, {ImGui::GetContentRegionAvail().x, 40.0f});
+    }
+    ImGui::End();
+}
+
+bool UI::SkipBackgroundTabs(const DrawEntry& entry)
+{
+    auto&     state = *entry.state;
+    const int after = settings.skip_hidden_after;
+    if (after <= 0 || state.background_tab_calls < after)
+        return false;
+
+    // selecting a tab is handled by its dock node, so it is noticed without calling the func
+    if (!std::ranges::all_of(state.windows, IsBackgroundDockTab))
+        return false;
+
+    // keep the windows alive, so their tabs stay in their dock nodes
+    auto& g = *ImGui::GetCurrentContext();
+    for (auto window : state.windows) {
+        window->LastFrameActive = g.FrameCount;
+        window->LastTimeActive  = (float)g.Time;
+    }
+    profiler.Count(background_tab_skips);
+    return true;
+}
+
+void UI::PreparePluginContexts(const DrawFuncList& draw_funcs, uint32_t frame)
+{
+    frame_contexts.clear();
+    ++context_frame;
+
+    auto add = [&](const DrawEntry& entry, bool menu) {
+        auto plugin_context = entry.context;
+        if (plugin_context->frame != context_frame) {
+            plugin_context->frame = context_frame;
+            plugin_context->Prepare(main_context, main_font, frame);
+            frame_contexts.push_back(plugin_context);
+        }
+        (menu ? plugin_context->menus : plugin_context->overlays).push_back(&entry);
+    };
+
+    for (const auto& overlay : draw_funcs.overlays)
+        if (overlay.context && overlay.state->enabled.load(std::memory_order_relaxed))
+            add(overlay, false);
+    if (show_menu)
+        for (const auto& menu : draw_funcs.menus)
+            if (menu.context && menu.state->enabled)
+                add(menu, true);
+
+    // z-order: registration order, with the focused context on top
+    if (auto it = std::ranges::find(frame_contexts, focused_context); it != frame_contexts.end())
+        std::rotate(it, it + 1, frame_contexts.end());
+}
+
+static bool IsModifierKey(ImGuiKey key)
+{
+    return (key >= ImGuiKey_LeftCtrl && key <= ImGuiKey_RightSuper) || (key >= ImGuiKey_ReservedForModCtrl && key <= ImGuiKey_ReservedForModSuper);
+}
+
+void UI::RouteInput()
+{
+    if (frame_contexts.empty() && !focused_context && !mouse_context)
+        return;
+
+    if (!show_menu) {
+        if (focused_context)
+            focused_context->ClearKeys();
+        focused_context = mouse_context = nullptr;
+        mouse_buttons                   = 0;
+        for (auto plugin_context : frame_contexts)
+            plugin_context->SetMousePos({-FLT_MAX, -FLT_MAX});
+        return;
+    }
+
+    // Events were queued into CatMenu's context by ProcessEvents and the backend; the ones meant
+    // for a plugin context are moved there before CatMenu's NewFrame consumes them.
+    auto& g = *ImGui::GetCurrentContext();
+
+    ImVec2 mouse_pos = g.IO.MousePos;
+    for (const auto& event : g.InputEventsQueue)
+        if (event.Type == ImGuiInputEventType_MousePos)
+            mouse_pos = {event.MousePos.PosX, event.MousePos.PosY};
+
+    // The mouse goes to the topmost context with a window under it, and stays there while a
+    // button is held. CatMenu's own windows are on top while it has focus. HoveredWindow and the
+    // plugin contexts' windows still describe the last frame.
+    if (!mouse_buttons) {
+        mouse_context = nullptr;
+        if (focused_context || !g.HoveredWindow)
+            for (auto it = frame_contexts.rbegin(); it != frame_contexts.rend(); ++it)
+                if ((*it)->HitTest(mouse_pos)) {
+                    mouse_context = *it;
+                    break;
+                }
+    }
+
+    // CatMenu keeps its own mouse position, so its software cursor stays put
+    for (auto plugin_context : frame_contexts)
+        plugin_context->SetMousePos(plugin_context == mouse_context ? mouse_pos : ImVec2{-FLT_MAX, -FLT_MAX});
+
+    const auto toggle_key = ImGuiKey{settings.toggle_key & ~ImGuiMod_Mask_};
+
+    int kept = 0;
+    for (int i = 0; i < g.InputEventsQueue.Size; ++i) {
+        const auto& event = g.InputEventsQueue[i];
+
+        PluginContext* target = nullptr;
+        switch (event.Type) {
+            case ImGuiInputEventType_MouseWheel:
+                target = mouse_context;
+                break;
+            case ImGuiInputEventType_MouseButton:
+                target = mouse_context;
+                if (event.MouseButton.Down) {
+                    mouse_buttons |= 1 << event.MouseButton.Button;
+                    // click to focus
+                    if (focused_context != mouse_context) {
+                        if (focused_context)
+                            focused_context->ClearKeys();
+                        else
+                            g.IO.ClearInputKeys();
+                        focused_context = mouse_context;
+                    }
+                } else
+                    mouse_buttons &= ~(1 << event.MouseButton.Button);
+                break;
+            case ImGuiInputEventType_Key:
+                // CatMenu still needs modifiers and its toggle key
+                if (focused_context)
+                    focused_context->ForwardEvent(event);
+                if (focused_context && !IsModifierKey(event.Key.Key) && event.Key.Key != toggle_key)
+                    continue;
+                break;
+            case ImGuiInputEventType_Text:
+                target = focused_context;
+                break;
+            case ImGuiInputEventType_Focus:
+                for (auto plugin_context : frame_contexts)
+                    plugin_context->ForwardEvent(event);
+                break;
+            default:
+                break;
+        }
+
+        if (target) {
+            target->ForwardEvent(event);
+            continue;
+        }
+        g.InputEventsQueue[kept++] = event;
+    }
+    g.InputEventsQueue.resize(kept);
+}
+
+static void BuildPluginContext(void* arg)
+{
+    auto plugin_context = static_cast<PluginContext*>(arg);
+    plugin_context->Build();
+    plugin_context->building.store(false, std::memory_order_release);
+    plugin_context->building.notify_one();
+}
+
+void UI::DispatchPluginContexts()
+{
+    // Workers build the plugin contexts while this thread builds CatMenu's.
+    contexts_dispatched = !frame_contexts.empty() && settings.parallel_contexts;
+    if (!contexts_dispatched)
+        return;
+
+    if (!context_workers)
+        context_workers = std::make_unique<WorkerPool>(std::clamp(std::thread::hardware_concurrency() / 2, 1u, 8u));
+
+    for (auto plugin_context : frame_contexts) {
+        plugin_context->building.store(true, std::memory_order_relaxed);
+        context_workers->Submit(BuildPluginContext, plugin_context);
+    }
+}
+
+void UI::MergePluginContexts(ImDrawData* draw_data)
+{
+    if (frame_contexts.empty())
+        return;
+
+    for (auto plugin_context : frame_contexts) {
+        if (contexts_dispatched)
+            plugin_context->building.wait(true, std::memory_order_acquire);
+        else
+            plugin_context->Build();
+
+        if (plugin_context->zone == Profiler::InvalidZone)
+            plugin_context->zone = profiler.AddZone(std::format("Context: {}", plugin_context->GetName()));
+        profiler.Record(plugin_context->zone, plugin_context->build_ms);
+    }
+    contexts_dispatched = false;
+
+    // Above CatMenu's windows but beneath its foreground (software cursor), or right above its
+    // background while CatMenu has focus.
+    int index = 0;
+    if (focused_context) {
+        index = draw_data->CmdListsCount;
+        if (index && draw_data->CmdLists[index - 1] == ImGui::GetForegroundDrawList())
+            --index;
+    } else if (draw_data->CmdListsCount && draw_data->CmdLists[0] == ImGui::GetBackgroundDrawList())
+        index = 1;
+
+    for (auto plugin_context : frame_contexts)
+        if (auto plugin_draw_data = plugin_context->GetDrawData())
+            for (ImDrawList* list : plugin_draw_data->CmdLists)
+                InsertDrawList(draw_data, index, list);
+}
+
+size_t UI::GetUIMemory()
+{
+    auto capacity = [](const auto& vector) { return vector.capacity() * sizeof(*vector.data()); };
+
+    size_t bytes = GetContextMemory(main_context) + ImGui::GetNotificationMemory();
+    bytes += capacity(draw_calls) + capacity(overlay_captures) + capacity(overlay_replays) + budget.GetMemory() + capacity(frame_contexts);
+
+    std::lock_guard lock(plugin_contexts_mutex);
+    for (const auto& plugin_context : plugin_contexts)
+        bytes += plugin_context->GetMemory();
+    return bytes;
+}
+
+void UI::Trim(const DrawFuncList& draw_funcs, bool idle)
+{
+    trim_time   = {};
+    trim_before = GetUIMemory();
+
+    // idle: nothing of the last frame is submitted again, nor is it of contexts left out of it
+    CompactContext(main_context, idle);
+    {
+        std::lock_guard lock(plugin_contexts_mutex);
+        for (const auto& plugin_context : plugin_contexts)
+            plugin_context->Compact(idle || std::ranges::find(frame_contexts, plugin_context.get()) == frame_contexts.end());
+    }
+
+    // down to what the overlays alone can use, so the frames that follow do not allocate again
+    const size_t overlays = draw_funcs.overlays.size();
+    auto         shrink   = [overlays](auto& vector) {
+        if (vector.capacity() > overlays) {
+            std::remove_reference_t<decltype(vector)>{}.swap(vector);
+            vector.reserve(overlays);
+        }
+    };
+    shrink(draw_calls);
+    shrink(overlay_captures);
+    shrink(overlay_replays);
+    budget.Shrink(overlays);
+    shrink(frame_contexts); // refilled by PreparePluginContexts
+    ImGui::ShrinkNotifications();
+
+    trim_after        = GetUIMemory();
+    shown_memory_time = {};
+    logger::info("Trimmed UI memory from {} KiB to {} KiB.", trim_before / 1024, trim_after / 1024);
+}
+
+static void RunUpdate(void* arg)
+{
+    auto update = static_cast<DrawFuncUpdate*>(arg);
+    update->func(update->buffers[1 - update->front]);
+    update->state.store(DrawFuncUpdate::State::Idle, std::memory_order_release);
+}
+
+void UI::KickUpdates(const DrawFuncList& draw_funcs)
+{
+    // Started after the frame is submitted, so they overlap the game's next simulation step.
+    for (const auto& overlay : draw_funcs.overlays) {
+        auto& update = overlay.state->update;
+        if (!update || update->submitted || !overlay.state->enabled.load(std::memory_order_relaxed))
+            continue;
+
+        auto idle = DrawFuncUpdate::State::Idle;
+        if (!update->state.compare_exchange_strong(idle, DrawFuncUpdate::State::Busy, std::memory_order_acq_rel))
+            continue; // removed
+
+        update->submitted = true;
+        workers->Submit(RunUpdate, update.get());
+    }
+}
+
+void UI::CaptureOverlays()
+{
+    // UpdateVisibility has collected their windows, in display order
+    for (auto state : overlay_captures) {
+        state->replay.Clear();
+        state->replay_windows.clear();
+
+        for (ImGuiWindow* window : state->windows) {
+            if (window->Hidden)
+                continue;
+            state->replay_windows.push_back(window);
+            if (!window->DrawList->CmdBuffer.empty() && !window->DrawList->IdxBuffer.empty())
+                state->replay.Add(window->DrawList);
+        }
+    }
+
+    overlay_captures.clear();
+}
+
+void UI::ReplayOverlays(ImDrawData* draw_data)
+{
+    // beneath every live window, but above the background draw list
+    int index = 0;
+    if (draw_data->CmdListsCount && draw_data->CmdLists[0] == ImGui::GetBackgroundDrawList())
+        index = 1;
+
+    for (auto state : overlay_replays)
+        state->replay.InsertInto(draw_data, index);
+
+    overlay_replays.clear();
+}
+
+void UI::DrawConfigWindow(const DrawFuncList& draw_funcs)
 {
     const ImGuiViewport* viewport = ImGui::GetMainViewport();
     ImGui::SetNextWindowPos({viewport->WorkSize.x * 0.1f, viewport->WorkSize.y * 0.2f}, ImGuiCond_FirstUseEver);
@@ -458,19 +1098,44 @@ void UI::DrawConfigWindow()
     }
 
     // toggle key
-    auto key_name = KeyToString(ImGuiKey{settings.toggle_key});
-    ImGui::InputTextWithHint("Toggle Button", "Click to set keyboard shortcut", &key_name,
-                             ImGuiInputTextFlags_ReadOnly | ImGuiInputTextFlags_NoUndoRedo | ImGuiInputTextFlags_NoHorizontalScroll);
-    if (ImGui::IsItemActive()) {
-        const auto last_key_pressed = InputHandler::GetSingleton()->GetLastKeyPressed();
-        if (last_key_pressed != ImGuiKey_None) {
-            settings.toggle_key = last_key_pressed;
-            ImGui::ClearActiveID();
-        }
-    }
+    DrawKeyField("Toggle Button", settings.toggle_key, toggle_key_name);
     if (ImGui::IsItemHovered())
         ImGui::SetTooltip("Click in the field and press any key to change the shortcut.");
 
+    ImGui::SliderInt("Overlay Refresh Rate", &settings.overlay_refresh_rate, 0, 144, settings.overlay_refresh_rate > 0 ? "%d Hz" : "Every Frame");
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("How often overlays and notifications are redrawn while the menu is closed.\n"
+                          "The last frame is shown again in between. 0 redraws every frame.");
+
+    ImGui::Checkbox("Pipelined UI Thread", &settings.pipelined_ui);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Build menus and overlays on a separate thread; the game's render thread only submits them.\n"
+                          "Adds one frame of latency, and draw funcs no longer run on the render thread.\n"
+                          "Takes effect after saving settings and restarting the game.");
+
+    ImGui::Checkbox("Parallel Plugin Contexts", &settings.parallel_contexts);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Build plugins that use their own ImGui context on worker threads, in parallel with CatMenu.\n"
+                          "When off they are built one after another on the UI thread.");
+
+    ImGui::Checkbox("Merge Draw Commands", &settings.merge_draw_cmds);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Combine draw commands of different windows and plugins that share a texture into fewer draw calls.\n"
+                          "Costs a copy of the frame's vertices on the UI thread; the Stats HUD shows the calls saved.");
+
+    ImGui::SliderInt("Skip Background Tabs After", &settings.skip_hidden_after, 0, 600, settings.skip_hidden_after > 0 ? "%d frames" : "Never");
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Stop calling a menu or overlay whose windows have all been background dock tabs for this long.\n"
+                          "It is called again as soon as one of its tabs is selected. 0 always calls it.");
+
+    ImGui::BeginDisabled(!pipeline.IsRunning());
+    ImGui::SliderFloat("Frame Deadline (ms)", &settings.frame_deadline_ms, 0.0f, 16.0f, "%.1f");
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+        ImGui::SetTooltip("Pipelined mode only. How long the render thread waits for the current UI frame.\n"
+                          "A frame that takes longer is shown one frame late and the previous one is shown again.\n"
+                          "0 never waits: the UI is always one frame behind.");
+    ImGui::EndDisabled();
+
     // fonts
     ImGui::SeparatorText("Font");
 
@@ -527,6 +1192,88 @@ void UI::DrawConfigWindow()
         ImGui::TreePop();
     }
 
+    // frame budget
+    ImGui::SeparatorText("Frame Budget");
+
+    ImGui::SliderFloat("Budget (ms)", &settings.frame_budget_ms, 0.0f, 16.0f, "%.1f");
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("CPU time all overlays and menus may take per frame together.\n0, the default, disables the budget.");
+
+    ImGui::SliderInt("Strikes", &settings.budget_strikes, 1, 300);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("How many times a draw func may exceed its share of an overrun budget\nbefore an overlay is demoted or a menu is warned about.\n"
+                          "Strikes wear off over Recovery calls within the share.");
+
+    ImGui::SliderInt("Recovery", &settings.budget_recovery, 1, 3000);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("How many calls in a row a demoted overlay has to stay within its share\nbefore its update rate is doubled again.");
+
+    ImGui::SliderInt("Max Interval", &settings.budget_max_interval, 1, 64);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Demoted overlays are updated at least once every this many frames.");
+
+    FrameBudget::DrawState(draw_funcs);
+
+    // memory
+    ImGui::SeparatorText("Memory");
+
+    ImGui::SliderFloat("Trim After (s)", &settings.trim_after_s, 0.0f, 120.0f, settings.trim_after_s > 0.0f ? "%.0f s" : "Never");
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("How long after the menu closes the memory its windows used is released.\n"
+                          "It is allocated again when they are next shown. 0 never releases it.");
+
+    if (clock.Now() >= shown_memory_time) {
+        shown_memory      = GetUIMemory();
+        shown_memory_time = clock.Now() + 1s;
+    }
+    ImGui::Text("UI memory: ~%.1f KiB", shown_memory / 1024.0);
+    if (trim_before)
+        ImGui::Text("Last trim: %.1f KiB -> %.1f KiB", trim_before / 1024.0, trim_after / 1024.0);
+    else
+        ImGui::TextDisabled("Not trimmed yet.");
+
+    if (auto sizer = backend->GetBufferSizer()) {
+        ImGui::Text("Renderer buffers: %d vertices, %d indices", sizer->GetVertexCapacity(), sizer->GetIndexCapacity());
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Grown past the largest frame so far, shrunk after a long stretch of much smaller frames.\n"
+                              "Saving settings stores this session's peak, and the buffers start that big next time.");
+        ImGui::Text("Peak frame: %d vertices, %d indices; %llu resizes", sizer->GetPeakVertices(), sizer->GetPeakIndices(),
+                    (unsigned long long)sizer->GetResizeCount());
+    }
+
+    // tracing and capture
+    ImGui::SeparatorText("Diagnostics");
+
+    DrawKeyField("Dump Trace Key", settings.trace_key, trace_key_name);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Click in the field and press any key to dump a trace with it.\n"
+                          "Only works while overlays, notifications or the menu are drawn.");
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Clear"))
+        settings.trace_key = ImGuiKey_None;
+
+    ImGui::SliderFloat("Trace Length (s)", &settings.trace_seconds, 1.0f, 30.0f, "%.0f s");
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("How much history a trace holds, at most.\nVery busy UIs hold less.");
+
+    ImGui::SliderFloat("Dump On Hitch (ms)", &settings.trace_hitch_ms, 0.0f, 200.0f, settings.trace_hitch_ms > 0.0f ? "%.0f ms" : "Never");
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Dump a trace when a game frame takes longer than this, at most once per trace length.\n"
+                          "0 never dumps on its own.");
+
+    if (ImGui::Button("Dump Trace", ImVec2(-FLT_MIN, 0)))
+        trace_requested.store(true, std::memory_order_relaxed);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Write the last frames' timings as Chrome trace JSON next to the log,\n"
+                          "to open in chrome://tracing or ui.perfetto.dev.");
+
+    ImGui::SliderInt("Capture Frames", &settings.capture_frames, 1, 1000);
+    if (ImGui::Button("Capture Draw Data", ImVec2(-FLT_MIN, 0)))
+        RequestDrawCapture(settings.capture_frames);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Write the next frames' draw data next to the log, to replay them with catmenu_bench --replay\n"
+                          "when working on the renderer. The capture includes everything drawn, text too.");
+
     ImGui::End();
 }
 
@@ -548,14 +1295,61 @@ void UI::DrawThemeEditor()
     auto& style  = ImGui::GetStyle();
     auto& colors = style.Colors;
     for (int i = 0; i < ImGuiCol_COUNT; ++i) {
-        auto color_name = magic_enum::enum_name((ImGuiCol_)i);
-        if (ImGui::ColorEdit4(color_name.data() + 9, &settings.theme_colors[i].x))
+        if (ImGui::ColorEdit4(ImGui::GetStyleColorName(i), &settings.theme_colors[i].x))
             colors[i] = settings.theme_colors[i];
     }
 
     ImGui::End();
 }
 
+void UI::TraceDump::Write(void* arg)
+{
+    auto       dump    = static_cast<TraceDump*>(arg);
+    const bool written = dump->snapshot.Write(dump->path);
+    if (written)
+        logger::info("Trace written to {}.", dump->path.string());
+    else
+        logger::warn("Failed to write trace to {}.", dump->path.string());
+    dump->state.store(written ? State::Written : State::Failed, std::memory_order_release);
+}
+
+void UI::DumpTrace()
+{
+    // Only the copy is taken here; formatting a few thousand events as JSON and writing them
+    // would be a hitch of its own.
+    const auto time = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+    trace_dump.path = output_directory / std::format("catmenu_trace_{:%Y%m%d_%H%M%S}.json", time);
+    profiler.SnapshotTrace(trace_dump.snapshot, settings.trace_seconds);
+
+    trace_dump.state.store(TraceDump::State::Writing, std::memory_order_relaxed);
+    workers->Submit(TraceDump::Write, &trace_dump);
+}
+
+void UI::FinishTraceDump()
+{
+    // toasts are not thread-safe, so the worker leaves them to the next frame
+    switch (trace_dump.state.load(std::memory_order_acquire)) {
+        case TraceDump::State::Written:
+            ImGui::InsertNotification({ImGuiToastType::Info, 5000, "Trace written to %s.", trace_dump.path.string().c_str()});
+            break;
+        case TraceDump::State::Failed:
+            ImGui::InsertNotification({ImGuiToastType::Warning, 5000, "Failed to write trace to %s.", trace_dump.path.string().c_str()});
+            break;
+        default:
+            return;
+    }
+    trace_dump.state.store(TraceDump::State::Idle, std::memory_order_relaxed);
+}
+
+void UI::RequestDrawCapture(int frames, std::filesystem::path path)
+{
+    if (path.empty()) {
+        const auto time = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+        path            = output_directory / std::format("catmenu_capture_{:%Y%m%d_%H%M%S}.cmdc", time);
+    }
+    capture.Request(frames, std::move(path));
+}
+
 void UI::SaveSettings()
 {
     std::ofstream o(g_config_path.data());
@@ -566,6 +1360,11 @@ void UI::SaveSettings()
         return;
     }
 
+    if (auto sizer = backend->GetBufferSizer(); sizer && sizer->GetPeakVertices()) {
+        settings.buffer_peak_vertices = sizer->GetPeakVertices();
+        settings.buffer_peak_indices  = sizer->GetPeakIndices();
+    }
+
     nlohmann::json settings_json = settings;
     o << settings_json.dump(4);
 
@@ -602,6 +1401,11 @@ void UI::LoadSettings()
     logger::info("{}", msg);
     ImGui::InsertNotification({ImGuiToastType::Success, 5000, msg.c_str()});
 
+    ApplySettings();
+}
+
+void UI::ApplySettings()
+{
     should_load_fonts = true;
     SetupTheme();
 }
@@ -2,24 +2,27 @@
 
 #include "imgui.h"
 
+#include "backend.h"
+#include "draw_capture.h"
+#include "frame_budget.h"
+#include "frame_clock.h"
+#include "frame_pipeline.h"
 #include "menu_api.h"
+#include "plugin_context.h"
+#include "profiler.h"
+#include "registry.h"
+#include "worker_pool.h"
 
 namespace CatMenu
 {
 
-struct DrawFunc
-{
-    std::string           name;
-    std::function<bool()> func;
-    bool                  enabled = true; // only for menu funcs
-};
-
 class UI
 {
 public:
     struct Settings
     {
-        int toggle_key = ImGuiKey_Backslash;
+        int toggle_key           = ImGuiKey_Backslash;
+        int overlay_refresh_rate = 0; // Hz while the menu is closed, 0 for every frame
 
         std::string font_path        = "Data\\SKSE\\Plugins\\catmenu\\fonts\\Atkinson-Hyperlegible-Regular-102.ttf";
         float       font_size        = 16.0f;
@@ -32,6 +35,38 @@ public:
         bool        glyph_thai       = false;
         bool        glyph_viet       = false;
 
+        // frame budget for the overlay and menu pass, 0 (the default) to disable
+        float frame_budget_ms     = 0.0f;
+        int   budget_strikes      = 30;  // calls over their share before an overlay is demoted
+        int   budget_recovery     = 600; // calls within their share before it is promoted again
+        int   budget_max_interval = 8;   // slowest update interval a demoted overlay can reach
+
+        // build frames on a CatMenu thread, read once at the first frame
+        bool  pipelined_ui      = false;
+        float frame_deadline_ms = 0.0f; // wait this long for the current frame, 0 to always submit the last completed one
+
+        bool parallel_contexts = true; // build plugin contexts on workers, otherwise one after another
+
+        bool merge_draw_cmds = false; // coalesce draw commands across lists before submitting, see DrawCmdMerger
+
+        // calls with all its windows in background dock tabs before a func is skipped, 0 to always call it;
+        // collapsed or otherwise hidden windows do not count, see UpdateVisibility
+        int skip_hidden_after = 60;
+
+        float trim_after_s = 10.0f; // after the menu closes, release the memory held for it, 0 to never
+
+        bool show_stats_hud = false; // RenderStats overlay, also while the menu is closed
+
+        // trace dumps, see TraceRing
+        int   trace_key      = ImGuiKey_None; // dumps while UI frames are built
+        float trace_seconds  = 5.0f;          // of history per dump
+        float trace_hitch_ms = 0.0f;          // dump when a game frame takes longer, 0 to never
+
+        int capture_frames = 120; // frames per draw data capture
+
+        // largest frame when settings were last saved; the renderer's buffers start this big, see BufferSizer
+        int buffer_peak_vertices = 0;
+        int buffer_peak_indices  = 0;
 
         // Theme by @Maksasj, edited by FiveLimbedCat
         // url: https://github.com/ocornut/imgui/issues/707#issuecomment-1494706165
@@ -104,32 +139,189 @@ private:
         auto& io = ImGui::GetIO();
         io.ClearInputCharacters();
         io.ClearInputKeys();
-        show_menu = enabled.value_or(!show_menu);
+
+        const bool was_open = show_menu;
+        show_menu           = enabled.value_or(!show_menu);
+        if (show_menu)
+            trim_time = {};
+        else if (was_open && settings.trim_after_s > 0.0f)
+            trim_time = clock.Now() + std::chrono::duration_cast<FrameClock::Clock::duration>(std::chrono::duration<float>(settings.trim_after_s));
     }
 
     Settings settings;
 
-    std::mutex               list_mutex;
-    StringMap<DrawFunc>      overlay_list;
-    std::vector<std::string> overlay_order;
-    StringMap<DrawFunc>      menu_list;
-    std::vector<std::string> menu_order;
+    std::unique_ptr<RenderBackend> backend;
+
+    ImGuiContext*    main_context = nullptr;
+    DrawFuncRegistry registry;
+    FrameClock       clock;
 
     void SetupTheme();
 
     bool    should_load_fonts = false;
+    bool    fonts_rebuilt     = false; // cached overlay lists need to be invalidated
     ImFont* main_font         = nullptr;
     void    LoadFonts();
 
+    // Runs the ImGui frame up to Render. Returns the draw data to submit, nullptr if the frame
+    // was skipped as idle.
+    ImDrawData* BuildFrame(const DrawFuncList& draw_funcs);
+
+    // With the menu closed, frames are only rebuilt at settings.overlay_refresh_rate and the last
+    // one is submitted again in between.
+    std::atomic<int>      refresh_rate = 0; // published by each built frame, 0 while the menu is open or fonts are due
+    FrameClock::TimePoint next_build_time;  // render thread
+    FrameClock::TimePoint last_build_time;  // ImGui's delta time spans the frames in between
+    bool                  IsRefreshDue();
+
     bool show_config = false;
-    void DrawConfigWindow();
+    void DrawConfigWindow(const DrawFuncList& draw_funcs);
+
+    // KeyToString of a key setting, only rebuilt when the key changes
+    struct KeyName
+    {
+        std::string  name;
+        int          of = -1;
+        std::string& Get(int key);
+    };
+    KeyName toggle_key_name;
+    KeyName trace_key_name;
+    void    DrawKeyField(const char* label, int& key, KeyName& name);
 
     bool show_theme_editor = false;
     void DrawThemeEditor();
 
+    bool     show_performance = false;
+    Profiler profiler;
+    struct
+    {
+        Profiler::ZoneId frame;
+        Profiler::ZoneId process_events;
+        Profiler::ZoneId load_fonts;
+        Profiler::ZoneId new_frame;
+        Profiler::ZoneId render;
+        Profiler::ZoneId render_draw_data;
+        Profiler::ZoneId hash_draw_data;
+        Profiler::ZoneId merge_draw_cmds;
+        Profiler::ZoneId notifications;
+    } zones;
+    Profiler::ZoneId GetZone(const DrawEntry& entry, std::string_view kind);
+
+    // Nothing to draw: no menu, no overlays, no toasts. The ImGui frame is skipped entirely.
+    Profiler::CounterId idle_frames;
+    bool                IsIdle(const DrawFuncList& draw_funcs) const;
+
+    Profiler::CounterId late_frames;   // mirrored from pipeline by the UI thread
+    Profiler::CounterId reused_frames;
+    Profiler::CounterId submits;       // mirrored from the atomics below by the UI thread
+    Profiler::CounterId skipped_uploads;
+
+    // draw funcs called this frame, see UpdateVisibility
+    std::vector<DrawCall> draw_calls;
+    std::atomic<uint32_t> built_frames = 0; // frames whose visibility is complete
+
+    // Funcs whose windows have all been background dock tabs for settings.skip_hidden_after calls
+    // are not called until one of their tabs is selected again.
+    Profiler::CounterId background_tab_skips;
+    bool                SkipBackgroundTabs(const DrawEntry& entry);
+
+    // overlays with an update interval
+    std::vector<DrawFunc*> overlay_captures; // called this frame
+    std::vector<DrawFunc*> overlay_replays;  // skipped this frame
+    void                   CaptureOverlays();
+    void                   ReplayOverlays(ImDrawData* draw_data);
+
+    FrameBudget budget; // settings.frame_budget_ms
+
+    // A trace dump in flight: the ring is copied by the frame that asked for it and written to
+    // path by a worker; the next frame after that shows the outcome. See DumpTrace.
+    struct TraceDump
+    {
+        enum class State
+        {
+            Idle,
+            Writing,
+            Written,
+            Failed
+        };
+        TraceSnapshot         snapshot;
+        std::filesystem::path path;
+        std::atomic<State>    state = State::Idle;
+
+        static void Write(void* arg); // WorkerPool task
+    } trace_dump; // declared before workers, which write it
+
+    // overlay update phases, trace dumps
+    std::unique_ptr<WorkerPool> workers;
+    void                        KickUpdates(const DrawFuncList& draw_funcs);
+
+    // plugin contexts, see PluginContext
+    std::mutex                                  plugin_contexts_mutex;
+    std::vector<std::unique_ptr<PluginContext>> plugin_contexts; // guarded, only ever appended to
+    std::unique_ptr<WorkerPool>                 context_workers; // declared after the contexts it builds
+    std::vector<PluginContext*>                 frame_contexts;  // with funcs to draw this frame, bottom to top
+    int                                         context_frame       = 0;
+    bool                                        contexts_dispatched = false;
+    PluginContext*                              focused_context     = nullptr; // keyboard, nullptr for CatMenu's own
+    PluginContext*                              mouse_context       = nullptr;
+    int                                         mouse_buttons       = 0; // held, the mouse stays with mouse_context meanwhile
+    void                                        PreparePluginContexts(const DrawFuncList& draw_funcs, uint32_t frame);
+    void                                        RouteInput();
+    void                                        DispatchPluginContexts();
+    void                                        MergePluginContexts(ImDrawData* draw_data);
+
+    // A while after the menu closes, the window buffers and CatMenu containers it grew are
+    // released, see CompactContext.
+    FrameClock::TimePoint trim_time;       // empty while no trim is pending
+    size_t                trim_before = 0; // UI memory around the last trim, 0 before the first
+    size_t                trim_after  = 0;
+    void                  Trim(const DrawFuncList& draw_funcs, bool idle);
+
+    // GetUIMemory for the config window, which walks every context and window: once a second
+    // and after each trim
+    size_t                shown_memory = 0;
+    FrameClock::TimePoint shown_memory_time; // empty to refresh on the next frame
+
+    // one entry per built frame, read through the API from any thread
+    std::mutex                                     render_stats_mutex;
+    std::array<RenderStats, Profiler::HistorySize> render_stats{}; // ring buffer, guarded
+    int                                            render_stats_head  = 0; // next write
+    int                                            render_stats_count = 0;
+    void                                           RecordRenderStats(const RenderStats& stats);
+    void                                           DrawStatsHud();
+
+    // settings.merge_draw_cmds, with the draw calls of the last built frame before and after
+    DrawCmdMerger       draw_cmd_merger;
+    uint32_t            last_draw_calls   = 0;
+    uint32_t            last_merged_calls = 0;
+    Profiler::CounterId draw_calls_total;
+    Profiler::CounterId merged_calls_total;
+
+    std::filesystem::path output_directory;        // for traces and captures
+    std::atomic<bool>     trace_requested = false; // dumped by the next built frame with no dump in flight
+    FrameClock::TimePoint next_auto_trace;         // render thread; one automatic dump per trace_seconds
+    void                  DumpTrace();
+    void                  FinishTraceDump();
+
+    DrawCaptureRecorder capture; // see RequestDrawCapture
+
     void SaveSettings();
     void LoadSettings();
 
+    ImDrawData* submitted_draw_data = nullptr; // last frame handed to the backend
+    uint64_t    submitted_hash      = 0;       // of submitted_draw_data, see HashDrawData
+
+    // Frames whose hash matches the last upload are drawn from the backend's buffers as they are.
+    std::atomic<uint64_t> submit_count         = 0; // render thread
+    std::atomic<uint64_t> skipped_upload_count = 0;
+    void                  Submit(ImDrawData* draw_data, uint64_t hash);
+
+    // settings.pipelined_ui, see FramePipeline
+    bool          pipeline_latched = false; // mode decided
+    void          DrawPipelined();
+    uint64_t      BuildPipelined(DrawDataSnapshot& back); // on the pipeline thread
+    FramePipeline pipeline;                               // declared last, so its thread is joined before anything it uses is destroyed
+
 public:
     static UI* GetSingleton()
     {
@@ -137,12 +329,52 @@ public:
         return std::addressof(ui);
     }
 
-    inline bool IsMenuOpen() { return show_menu; }
+    inline ImGuiContext* GetContext() { return main_context; } // CatMenu's own, nullptr before Init
+    inline RenderBackend* GetBackend() { return backend.get(); } // nullptr before Init
+    inline bool          IsMenuOpen() { return show_menu; }
+    inline Settings&     GetSettings() { return settings; }
+    inline FrameClock&   GetFrameClock() { return clock; }
+    inline uint64_t      GetIdleFrameCount() const { return profiler.GetCount(idle_frames); } // counters are atomic, any thread
+    inline uint64_t      GetLateFrameCount() const { return pipeline.GetLateFrameCount(); }
+    inline uint64_t      GetReusedFrameCount() const { return pipeline.GetReusedFrameCount(); }
+    inline uint64_t      GetSubmitCount() const { return submit_count.load(std::memory_order_relaxed); }
+    inline uint64_t      GetSkippedUploadCount() const { return skipped_upload_count.load(std::memory_order_relaxed); }
+    inline uint64_t      GetDrawCallCount() const { return profiler.GetCount(draw_calls_total); } // built, before merging
+    inline uint64_t      GetMergedDrawCallCount() const { return profiler.GetCount(merged_calls_total); }
+    inline ImDrawData*   GetSubmittedDrawData() { return submitted_draw_data; } // nullptr if the last Draw submitted nothing
+    size_t               GetUIMemory();                                         // estimate, see GetContextMemory
 
-    APIResult RegisterOverlayDrawFunc(std::string_view name, std::function<bool()> func);
+    APIResult RegisterOverlayDrawFunc(std::string_view name, std::function<bool()> func, uint32_t update_interval = 1);
     APIResult RegisterMenuDrawFunc(std::string_view name, std::function<bool()> func);
+    APIResult SetMenuEnabled(std::string_view name, bool enabled);
+
+    DrawFuncHandle AddOverlayDrawFunc(std::string_view name, std::function<bool()> func, uint32_t update_interval = 1,
+                                      std::unique_ptr<DrawFuncUpdate> update = nullptr, PluginContext* context = nullptr);
+    DrawFuncHandle AddUpdatedOverlayDrawFunc(std::string_view name, void (*update)(void* back), bool (*draw)(const void* front),
+                                             void* buffer_a, void* buffer_b, uint32_t update_interval = 1);
+    DrawFuncHandle AddMenuDrawFunc(std::string_view name, std::function<bool()> func, PluginContext* context = nullptr);
+    APIResult      RemoveDrawFunc(DrawFuncHandle handle);
+    APIResult      SetDrawFuncEnabled(DrawFuncHandle handle, bool enabled);
+    APIResult      SwapDrawFuncOrder(DrawFuncHandle a, DrawFuncHandle b);
+    bool           IsDrawFuncVisible(DrawFuncHandle handle); // on the last built frame
+    uint32_t       GetRenderStats(RenderStats* out, uint32_t count);
+
+    PluginContext* CreatePluginContext(std::string_view name); // nullptr if the name is taken
+
+    inline void SetOutputDirectory(std::filesystem::path directory) { output_directory = std::move(directory); } // before the first Draw
+
+    // Built-in windows, drawn while the menu is open.
+    inline void ShowConfigWindow(bool show) { show_config = show; }
+    inline void ShowThemeEditor(bool show) { show_theme_editor = show; }
+
+    // After settings are changed through GetSettings: rebuilds the fonts and the style.
+    void ApplySettings();
+
+    // Writes the next frames handed to the renderer to path, or to a generated name in the output
+    // directory, see DrawCaptureWriter. Any thread.
+    void RequestDrawCapture(int frames, std::filesystem::path path = {});
 
-    void Init(IDXGISwapChain* swapchain, ID3D11Device* device, ID3D11DeviceContext* context);
+    void Init(std::unique_ptr<RenderBackend> render_backend);
     void Draw();
 };
 } // namespace CatMenu
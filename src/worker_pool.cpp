@@ -0,0 +1,49 @@
+#include "worker_pool.h"
+
+namespace CatMenu
+{
+
+WorkerPool::WorkerPool(unsigned thread_count)
+{
+    threads.reserve(thread_count);
+    for (unsigned i = 0; i < thread_count; ++i)
+        threads.emplace_back([this](std::stop_token stop) { Run(stop); });
+}
+
+WorkerPool::~WorkerPool()
+{
+    for (auto& thread : threads)
+        thread.request_stop();
+    has_jobs.notify_all();
+    threads.clear(); // joins
+}
+
+void WorkerPool::Submit(Task task, void* arg)
+{
+    {
+        std::lock_guard lock{mutex};
+        queue.push_back({task, arg});
+    }
+    has_jobs.notify_one();
+}
+
+void WorkerPool::Run(std::stop_token stop)
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock{mutex};
+            if (!has_jobs.wait(lock, stop, [this] { return head < queue.size(); }))
+                return;
+
+            job = queue[head++];
+            if (head == queue.size()) { // keeps the capacity
+                queue.clear();
+                head = 0;
+            }
+        }
+        job.task(job.arg);
+    }
+}
+
+} // namespace CatMenu
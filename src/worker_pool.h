@@ -0,0 +1,39 @@
+#pragma once
+
+namespace CatMenu
+{
+
+// Small fixed-size thread pool for work taken off the render thread.
+// Tasks are plain function pointers so submitting never allocates once the queue has grown to
+// its working size.
+class WorkerPool
+{
+public:
+    using Task = void (*)(void* arg);
+
+    explicit WorkerPool(unsigned thread_count);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&)            = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void Submit(Task task, void* arg);
+
+private:
+    struct Job
+    {
+        Task  task;
+        void* arg;
+    };
+
+    std::mutex                  mutex;
+    std::condition_variable_any has_jobs;
+    std::vector<Job>            queue; // FIFO from head, guarded by mutex
+    size_t                      head = 0;
+
+    std::vector<std::jthread> threads;
+
+    void Run(std::stop_token stop);
+};
+
+} // namespace CatMenu
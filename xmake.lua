@@ -56,6 +56,12 @@ target("imgui")
     add_files("lib/imgui/misc/cpp/imgui_stdlib.cpp")
     add_includedirs("lib/imgui/misc/cpp/", { public = true })
 
+    -- per-thread current context for workers, see src/imgui_config/imgui_config.h
+    add_files("src/imgui_config/imgui_tls.cpp")
+    add_includedirs("src/imgui_config/", { public = true })
+    add_defines("IMGUI_USER_CONFIG=\"imgui_config.h\"", { public = true })
+    add_defines("CATMENU_IMGUI_IMPL")
+
     add_defines("IMGUI_API=__declspec(dllexport)") -- export symbols
 
 target("catmenu")
@@ -70,6 +76,8 @@ target("catmenu")
 
     add_packages("spdlog", "unordered_dense", "nlohmann_json", "magic_enum")
 
+    add_syslinks("d3dcompiler") -- the DX11 renderer's shaders, see src/backend_dx11.cpp
+
     add_includedirs("lib")
     add_headerfiles("lib/detours/Detours.h")
     add_links("lib/detours/Release/detours.lib")
@@ -82,7 +90,59 @@ target("catmenu")
     })
 
     -- add src files
-    add_files("src/**.cpp")
+    add_files("src/**.cpp|imgui_config/*.cpp") -- built into imgui.dll
     add_headerfiles("src/**.h")
     add_includedirs("src")
     set_pcxxheader("src/pch.h")
+
+target("catmenu_bench")
+    set_kind("binary")
+    set_default(false)
+
+    -- headless: imgui core only, no dx11/win32 backends and no commonlib
+    add_files("lib/imgui/imgui*.cpp")
+    add_includedirs("lib/imgui/")
+    add_files("lib/imgui/misc/cpp/imgui_stdlib.cpp")
+    add_includedirs("lib/imgui/misc/cpp/")
+
+    -- one binary, so every file sees the thread_local GImGui override directly
+    add_files("src/imgui_config/imgui_tls.cpp")
+    add_includedirs("src/imgui_config/")
+    add_defines("IMGUI_USER_CONFIG=\"imgui_config.h\"", "CATMENU_IMGUI_IMPL")
+
+    add_packages("spdlog", "unordered_dense", "nlohmann_json", "magic_enum")
+
+    add_files(
+        "src/ui.cpp",
+        "src/profiler.cpp",
+        "src/registry.cpp",
+        "src/draw_data.cpp",
+        "src/worker_pool.cpp",
+        "src/plugin_context.cpp",
+        "src/ImGuiNotify.cpp",
+        "src/frame_clock.cpp",
+        "src/context_memory.cpp",
+        "src/trace.cpp",
+        "src/draw_capture.cpp",
+        "src/draw_hash.cpp",
+        "src/buffer_sizer.cpp",
+        "src/frame_budget.cpp",
+        "src/frame_pipeline.cpp",
+        "src/backend_null.cpp",
+        "src/backend_software.cpp",
+        "src/input.cpp")
+    add_includedirs("src")
+
+    add_files("bench/*.cpp")
+    add_headerfiles("bench/*.h")
+    add_includedirs("bench")
+    if not is_plat("windows") then
+        add_includedirs("bench/win32") -- Win32 and DirectInput headers of input.cpp
+    end
+    set_pcxxheader("bench/pch.h")
+
+    set_warnings("allextra", "error")
+    add_cxflags("-Wno-unknown-pragmas", { tools = { "gcc", "clang" } })
+    if not is_plat("windows") then
+        add_syslinks("pthread")
+    end